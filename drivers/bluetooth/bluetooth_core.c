@@ -32,6 +32,7 @@
 #include "eddystone.h"
 #include "ruuvi_endpoints.h"
 #include "ble_event_handlers.h" 
+#include "profiler.h"
 
 #if APP_GATT_PROFILE_ENABLED
 #include "application_service_if.h"
@@ -496,6 +497,7 @@ ret_code_t bluetooth_set_manufacturer_data(uint8_t* data, size_t length)
 
   //31 bytes - overhead - 2 bytes for manufacturer ID
   if(24 < length)  { return NRF_ERROR_INVALID_PARAM; }
+  PROFILER_BEGIN(PROFILER_SET_MANUFACTURER_DATA);
   if(0 == length ) { advdata.p_manuf_specific_data = NULL; }
   else 
   {
@@ -510,9 +512,12 @@ ret_code_t bluetooth_set_manufacturer_data(uint8_t* data, size_t length)
     memset(&advdata, 0, sizeof(advdata));
     advdata.p_manuf_specific_data = &m_manufacturer_data;
     advdata.flags = BLE_GAP_ADV_FLAGS_LE_ONLY_GENERAL_DISC_MODE;
+    PROFILER_BEGIN(PROFILER_BLE_ADVDATA_SET);
     err_code |= ble_advdata_set(&advdata, &scanresp);
+    PROFILER_END(PROFILER_BLE_ADVDATA_SET);
   }
   NRF_LOG_DEBUG("ADV data status %s\r\n", (uint32_t)ERR_TO_STR(err_code));
+  PROFILER_END(PROFILER_SET_MANUFACTURER_DATA);
 
   return err_code;
 }
@@ -528,6 +533,8 @@ ret_code_t bluetooth_set_manufacturer_data(uint8_t* data, size_t length)
 ret_code_t bluetooth_set_eddystone_url(char* url_buffer, size_t length)
 {
   ret_code_t err_code = eddystone_prepare_url_advertisement(&advdata, url_buffer, length);
+  PROFILER_BEGIN(PROFILER_BLE_ADVDATA_SET);
   err_code |= ble_advdata_set(&advdata, &scanresp);
+  PROFILER_END(PROFILER_BLE_ADVDATA_SET);
   return err_code;
 }
@@ -45,6 +45,7 @@
 
 #include "bme280.h"
 #include "init.h" //Timer ticks - todo: refactor
+#include "profiler.h"
 
 #define NRF_LOG_MODULE_NAME "BME280"
 #include "nrf_log.h"
@@ -56,14 +57,27 @@ struct bme280_driver bme280; /* global instance */
 /* Prototypes */
 void timer_bme280_event_handler(void* p_context);
 
-/** state variable **/
-static uint8_t current_mode = BME280_MODE_SLEEP;
-static uint8_t current_interval = BME280_STANDBY_1000_MS;
+/** Cached configuration registers. Mode is sleep, normal, or forced while sensor sleeps between
+ *  measurements triggered with bme280_set_mode. Power-on values until bme280_init **/
+static bme280_config_t current_config = {
+  .os_hum   = BME280_OVERSAMPLING_SKIP,
+  .os_temp  = BME280_OVERSAMPLING_SKIP,
+  .os_press = BME280_OVERSAMPLING_SKIP,
+  .iir      = BME280_IIR_OFF,
+  .interval = BME280_STANDBY_0_5_MS,
+  .mode     = BME280_MODE_SLEEP
+};
+
+/** Software IIR on raw values, state has IIR_FRACTION_BITS fractional bits **/
+#define IIR_FRACTION_BITS 4
+static uint8_t software_iir_shift = 0;
+static bool    software_iir_valid = false;
+static int32_t software_iir_t, software_iir_p, software_iir_h;
 
 BME280_Ret bme280_init()
 {
-  //Return error if not in sleep
-  if(BME280_MODE_SLEEP != current_mode){ return BME280_RET_ILLEGAL; }
+  //Return error if not sleeping
+  if(BME280_MODE_NORMAL == current_config.mode){ return BME280_RET_ILLEGAL; }
   /* Initialize SPI */
   if (!spi_isInitialized())
   {
@@ -121,72 +135,91 @@ BME280_Ret bme280_init()
   bme280.cp.dig_H5 |= bme280_read_reg(0xE6) << 4;		// 11:4
 
   bme280.cp.dig_H6  = bme280_read_reg(0xE7);
+
+  // Sensor keeps configuration over MCU reset
+  uint8_t hum  = bme280_read_reg(BME280REG_CTRL_HUM);
+  uint8_t meas = bme280_read_reg(BME280REG_CTRL_MEAS);
+  uint8_t conf = bme280_read_reg(BME280REG_CONFIG);
+  current_config.os_hum   = hum & BME280_OVERSAMPLING_MASK;
+  current_config.os_temp  = (meas >> 5) & BME280_OVERSAMPLING_MASK;
+  current_config.os_press = (meas >> 2) & BME280_OVERSAMPLING_MASK;
+  current_config.mode     = (BME280_MODE_NORMAL == (meas & BME280_MODE_MASK)) ? BME280_MODE_NORMAL : BME280_MODE_SLEEP;
+  current_config.iir      = conf & BME280_IIR_MASK;
+  current_config.interval = conf & BME280_INTERVAL_MASK;
  
   return BME280_RET_OK;
 }
 
+static uint8_t ctrl_meas_value(const bme280_config_t* const config, uint8_t mode)
+{
+  return (config->os_temp << 5) | (config->os_press << 2) | mode;
+}
+
+BME280_Ret bme280_configure(const bme280_config_t* const config)
+{
+  if(NULL == config) { return BME280_RET_NULL; }
+  if(!bme280.sensor_available) { return BME280_RET_ERROR; }
+  if(config->os_hum > BME280_OVERSAMPLING_MASK || config->os_temp > BME280_OVERSAMPLING_MASK ||
+     config->os_press > BME280_OVERSAMPLING_MASK || (config->iir & ~BME280_IIR_MASK) ||
+     (config->interval & ~BME280_INTERVAL_MASK) || (BME280_MODE_SLEEP != config->mode &&
+     BME280_MODE_FORCED != config->mode && BME280_MODE_NORMAL != config->mode))
+  {
+    return BME280_RET_ILLEGAL;
+  }
+  BME280_Ret status = BME280_RET_OK;
+
+  // Writes to CONFIG may be ignored in normal mode
+  if(BME280_MODE_NORMAL == current_config.mode)
+  {
+    status |= bme280_write_reg(BME280REG_CTRL_MEAS, ctrl_meas_value(&current_config, BME280_MODE_SLEEP));
+  }
+  // Address, value pairs in one transaction. CTRL_HUM takes effect on CTRL_MEAS write, which also sets mode.
+  uint8_t tx[6] = { BME280REG_CTRL_HUM & 0x7F,  config->os_hum,
+                    BME280REG_CONFIG & 0x7F,    config->interval | config->iir,
+                    BME280REG_CTRL_MEAS & 0x7F, ctrl_meas_value(config, config->mode) };
+  uint8_t rx[sizeof(tx)];
+  if(SPI_RET_OK != spi_transfer_bme280(tx, sizeof(tx), rx)) { status |= BME280_RET_ERROR; }
+
+  // Forced mode is kept, sensor sleeps between forced measurements and may be configured again
+  if(BME280_RET_OK == status) { current_config = *config; }
+  return status;
+}
+
+void bme280_get_configuration(bme280_config_t* const config)
+{
+  if(NULL != config) { *config = current_config; }
+}
+
 
 /*
- *  TODO: Adjust timer frequency by BME280 sampling speed.
- *  TODO: return APP_ERROR_CHECK values?
+ *  Mode change is one CTRL_MEAS write from cached configuration.
  */
 BME280_Ret bme280_set_mode(enum BME280_MODE mode)
 {
   NRF_LOG_DEBUG("Setting BME mode: %x\r\n", mode);
   if(!bme280.sensor_available) { return BME280_RET_ERROR;  }
-  uint8_t conf, reg;
-  
-  BME280_Ret status = BME280_RET_ERROR;
-  reg = bme280_read_reg(BME280REG_CTRL_HUM);
-  conf = bme280_read_reg(BME280REG_CTRL_MEAS);
-  NRF_LOG_DEBUG("CONFIG before mode: %x\r\n", conf);
-  status |= bme280_write_reg(BME280REG_CTRL_HUM, reg);  //HUMIDITY must be written first
-  conf = conf & 0b11111100;
-  conf |= mode;
-
-  switch(mode)
+  BME280_Ret status = bme280_write_reg(BME280REG_CTRL_MEAS, ctrl_meas_value(&current_config, mode));
+
+  // Forced measurement keeps cached sleep or forced mode, sensor returns to sleep after it
+  if(BME280_RET_OK == status)
   {
-    case BME280_MODE_NORMAL:
-      status |= bme280_write_reg(BME280REG_CTRL_MEAS, conf);
-      //conf = bme280_read_reg(BME280REG_CTRL_MEAS);
-      //NRF_LOG_DEBUG("Mode: %x\r\n", conf);
-      break;
-
-    case BME280_MODE_FORCED:
-      status |= bme280_write_reg(BME280REG_CTRL_MEAS, conf); //start new measurement
-      break;
-
-    case BME280_MODE_SLEEP:    
-      status |= bme280_write_reg(BME280REG_CTRL_MEAS, conf);     
-      break;
-
-    default:
-      break;
+    if(BME280_MODE_FORCED != mode)                     { current_config.mode = mode; }
+    else if(BME280_MODE_NORMAL == current_config.mode) { current_config.mode = BME280_MODE_SLEEP; }
   }
-
-  if(BME280_RET_OK == status) {current_mode = mode;}
   return status;
 }
 
 BME280_Ret bme280_set_interval(enum BME280_INTERVAL interval)
 {
-  if(BME280_MODE_SLEEP != current_mode){ return BME280_RET_ILLEGAL; }
-  uint8_t conf;
-  BME280_Ret status = BME280_RET_ERROR;
-
-  conf   = bme280_read_reg(BME280REG_CONFIG);
-  conf   = conf &~ BME280_INTERVAL_MASK;
-  conf  |= interval;      
-  status = bme280_write_reg(BME280REG_CONFIG, conf);
-  
-  if(NRF_SUCCESS == status) { current_interval = interval; }
-
-  return status;
+  if(BME280_MODE_NORMAL == current_config.mode){ return BME280_RET_ILLEGAL; }
+  bme280_config_t config = current_config;
+  config.interval = interval;
+  return bme280_configure(&config);
 }
 
 enum BME280_INTERVAL bme280_get_interval(void)
 {
-  return current_interval;
+  return current_config.interval;
 }
 
 
@@ -208,47 +241,71 @@ int bme280_is_measuring(void)
 
 BME280_Ret bme280_set_oversampling_hum(uint8_t os)
 {
-  if(BME280_MODE_SLEEP != current_mode){ return BME280_RET_ILLEGAL; }
-  uint8_t meas;
-  meas = bme280_read_reg(BME280REG_CTRL_MEAS);
-  bme280_write_reg(BME280REG_CTRL_HUM, os);
-  return bme280_write_reg(BME280REG_CTRL_MEAS, meas); //Changes to humi take effect after write to meas
+  if(BME280_MODE_NORMAL == current_config.mode){ return BME280_RET_ILLEGAL; }
+  bme280_config_t config = current_config;
+  config.os_hum = os;
+  return bme280_configure(&config);
 }
 
 
 BME280_Ret bme280_set_oversampling_temp(uint8_t os)
 {
-  if(BME280_MODE_SLEEP != current_mode){ return BME280_RET_ILLEGAL; }
-  uint8_t humi, meas;
-  humi = bme280_read_reg(BME280REG_CTRL_HUM);
-  meas = bme280_read_reg(BME280REG_CTRL_MEAS);
-  bme280_write_reg(BME280REG_CTRL_HUM, humi);
-  meas &= 0b00011111;
-  meas |= (os<<5);
-  return bme280_write_reg(BME280REG_CTRL_MEAS, meas);
+  if(BME280_MODE_NORMAL == current_config.mode){ return BME280_RET_ILLEGAL; }
+  bme280_config_t config = current_config;
+  config.os_temp = os;
+  return bme280_configure(&config);
 }
 
 
 BME280_Ret bme280_set_oversampling_press(uint8_t os)
 {
-  if(BME280_MODE_SLEEP != current_mode){ return BME280_RET_ILLEGAL; }
-  uint8_t humi, meas;
-  humi = bme280_read_reg(BME280REG_CTRL_HUM);
-  meas = bme280_read_reg(BME280REG_CTRL_MEAS);
-  bme280_write_reg(BME280REG_CTRL_HUM, humi);
-  meas &= 0b11100011;
-  meas |= (os<<2);
-  return bme280_write_reg(BME280REG_CTRL_MEAS, meas);
+  if(BME280_MODE_NORMAL == current_config.mode){ return BME280_RET_ILLEGAL; }
+  bme280_config_t config = current_config;
+  config.os_press = os;
+  return bme280_configure(&config);
 }
 	
 BME280_Ret bme280_set_iir(uint8_t iir)
 {
-   if(BME280_MODE_SLEEP != current_mode){ return BME280_RET_ILLEGAL; }
-   uint8_t conf = bme280_read_reg(BME280REG_CONFIG);
-   conf &= ~BME280_IIR_MASK;
-   conf |= BME280_IIR_MASK & iir;
-   NRF_LOG_DEBUG("Writing %d to %d\r\n", conf, BME280REG_CONFIG);
-   return bme280_write_reg(BME280REG_CONFIG, conf);
+  if(BME280_MODE_NORMAL == current_config.mode){ return BME280_RET_ILLEGAL; }
+  bme280_config_t config = current_config;
+  config.iir = BME280_IIR_MASK & iir;
+  return bme280_configure(&config);
+}
+
+BME280_Ret bme280_set_software_iir(uint8_t iir)
+{
+  if(iir & ~BME280_IIR_MASK) { return BME280_RET_ILLEGAL; }
+  // Coefficient 2^n is in bits 4:2 of register value
+  software_iir_shift = iir >> 2;
+  software_iir_valid = false;
+  return BME280_RET_OK;
+}
+
+/** Number of samples averaged by oversampling setting **/
+static uint32_t oversampling_count(uint8_t os)
+{
+  if(BME280_OVERSAMPLING_SKIP == os) { return 0; }
+  if(os > BME280_OVERSAMPLING_16)    { return 16; }
+  return 1 << (os - 1);
+}
+
+uint32_t bme280_measurement_time_us(void)
+{
+  // Datasheet appendix B, maximum measurement time
+  uint32_t time = 1250 + 2300 * oversampling_count(current_config.os_temp);
+  if(current_config.os_press) { time += 2300 * oversampling_count(current_config.os_press) + 575; }
+  if(current_config.os_hum)   { time += 2300 * oversampling_count(current_config.os_hum) + 575; }
+  return time;
+}
+
+/** First order low pass y += (x - y) / 2^shift, first sample initializes filter **/
+static int32_t software_iir(int32_t* state, int32_t value)
+{
+  int32_t input = value << IIR_FRACTION_BITS;
+  if(software_iir_valid) { *state += (input - *state) >> software_iir_shift; }
+  else                   { *state = input; }
+  return (*state + (1 << (IIR_FRACTION_BITS - 1))) >> IIR_FRACTION_BITS;
 }
 
 /**
@@ -258,6 +315,7 @@ BME280_Ret bme280_read_measurements()
 {
 
   if(!bme280.sensor_available) { return BME280_RET_ERROR;  }
+  PROFILER_BEGIN(PROFILER_BME280_READ_MEASUREMENTS);
   uint8_t data[BME280_BURST_READ_LENGTH];
   
   BME280_Ret err_code = bme280_read_burst(BME280REG_PRESS_MSB, BME280_BURST_READ_LENGTH, data);
@@ -272,11 +330,20 @@ BME280_Ret bme280_read_measurements()
   bme280.adc_p |= (uint32_t) data[2] << 4;
   bme280.adc_p |= (uint32_t) data[1] << 12;
 
+  if(software_iir_shift && BME280_RET_OK == err_code)
+  {
+    bme280.adc_t = software_iir(&software_iir_t, bme280.adc_t);
+    bme280.adc_p = software_iir(&software_iir_p, bme280.adc_p);
+    bme280.adc_h = software_iir(&software_iir_h, bme280.adc_h);
+    software_iir_valid = true;
+  }
+
+  PROFILER_END(PROFILER_BME280_READ_MEASUREMENTS);
   return err_code;
 }
 
 
-static uint32_t compensate_P_int64(int32_t adc_P)
+uint32_t bme280_compensate_P_int64(int32_t adc_P)
 {
 	int64_t var1, var2, p;
 
@@ -300,6 +367,39 @@ static uint32_t compensate_P_int64(int32_t adc_P)
 }
 
 
+/*
+ *  32-bit variant of Bosch reference, 1 Pa resolution. Result is shifted to Q24.8 like 64-bit variant.
+ */
+uint32_t bme280_compensate_P_int32(int32_t adc_P)
+{
+	int32_t var1, var2;
+	uint32_t p;
+
+	var1 = (bme280.t_fine >> 1) - (int32_t)64000;
+	var2 = (((var1 >> 2) * (var1 >> 2)) >> 11) * ((int32_t)bme280.cp.dig_P6);
+	var2 = var2 + ((var1 * ((int32_t)bme280.cp.dig_P5)) << 1);
+	var2 = (var2 >> 2) + (((int32_t)bme280.cp.dig_P4) << 16);
+	var1 = (((bme280.cp.dig_P3 * (((var1 >> 2) * (var1 >> 2)) >> 13)) >> 3) + ((((int32_t)bme280.cp.dig_P2) * var1) >> 1)) >> 18;
+	var1 = ((((32768 + var1)) * ((int32_t)bme280.cp.dig_P1)) >> 15);
+	if (var1 == 0) {
+		return 0;
+	}
+
+	p = (((uint32_t)(((int32_t)1048576) - adc_P) - (var2 >> 12))) * 3125;
+	// Division is unsigned 32-bit, keep numerator in range
+	if (p < 0x80000000) {
+		p = (p << 1) / ((uint32_t)var1);
+	} else {
+		p = (p / (uint32_t)var1) * 2;
+	}
+	var1 = (((int32_t)bme280.cp.dig_P9) * ((int32_t)(((p >> 3) * (p >> 3)) >> 13))) >> 12;
+	var2 = (((int32_t)(p >> 2)) * ((int32_t)bme280.cp.dig_P8)) >> 13;
+	p = (uint32_t)((int32_t)p + ((var1 + var2 + bme280.cp.dig_P7) >> 4));
+
+	return p << 8;
+}
+
+
 static uint32_t compensate_H_int32(int32_t adc_H)
 {
 	int32_t v_x1_u32r;
@@ -354,7 +454,11 @@ int32_t bme280_get_temperature(void)
  */
 uint32_t bme280_get_pressure(void)
 {
-	uint32_t press = compensate_P_int64(bme280.adc_p);
+#if BME280_PRESSURE_COMPENSATION_32BIT
+	uint32_t press = bme280_compensate_P_int32(bme280.adc_p);
+#else
+	uint32_t press = bme280_compensate_P_int64(bme280.adc_p);
+#endif
 	return press;
 }
 
@@ -55,6 +55,15 @@
 #include "nordic_common.h"
 #include "app_timer_appsh.h"
 
+/**
+ *  Pressure compensation with 32-bit integers only, 1 Pa resolution instead of 1/256 Pa.
+ *  Avoids 64-bit multiplies and division which are library calls on Cortex-M4.
+ *  host/bme280_compensation reports the difference to the 64-bit variant.
+ */
+#ifndef BME280_PRESSURE_COMPENSATION_32BIT
+#define BME280_PRESSURE_COMPENSATION_32BIT 0
+#endif
+
 struct comp_params {
 	uint16_t dig_T1;
 	int16_t  dig_T2;
@@ -124,6 +133,7 @@ typedef enum
 
 #define BME280_ID_VALUE          (0x60)
 
+#define BME280_OVERSAMPLING_MASK (0x07)
 #define BME280_OVERSAMPLING_SKIP (0x00)
 #define BME280_OVERSAMPLING_1    (0x01)
 #define BME280_OVERSAMPLING_2    (0x02)
@@ -139,6 +149,7 @@ typedef enum
 #define BME280_IIR_16            (0x10)
 
 #define BME280_INTERVAL_MASK     (0xE0)
+#define BME280_MODE_MASK         (0x03)
 
 #define BME280_BURST_READ_LENGTH (9) // 8 bytes + address
 #define BME280_MAX_READ_LENGTH BME280_BURST_READ_LENGTH
@@ -151,6 +162,16 @@ enum BME280_INTERVAL {
 	BME280_STANDBY_1000_MS = 0xA0
 };
 
+/** Sensor configuration, written with bme280_configure **/
+typedef struct {
+  uint8_t os_hum;    ///< BME280_OVERSAMPLING_x
+  uint8_t os_temp;   ///< BME280_OVERSAMPLING_x
+  uint8_t os_press;  ///< BME280_OVERSAMPLING_x
+  uint8_t iir;       ///< BME280_IIR_x
+  uint8_t interval;  ///< enum BME280_INTERVAL, standby time in normal mode
+  uint8_t mode;      ///< enum BME280_MODE entered once configuration is written
+}bme280_config_t;
+
 /** Structure containing sensor data from all 3 sensors */
 typedef struct {
   int32_t  temperature;
@@ -163,6 +184,21 @@ typedef struct {
  */
 BME280_Ret bme280_init();
 
+/**
+ *  Write complete configuration in one SPI transaction: CTRL_HUM, CONFIG and CTRL_MEAS.
+ *  CTRL_HUM takes effect on the following CTRL_MEAS write, which also sets the mode.
+ *  Sensor in normal mode is put to sleep first, as CONFIG writes may be ignored otherwise.
+ *  Configuration is cached, single setters below and bme280_set_mode modify the cached copy.
+ *
+ *  @return BME280_RET_NULL if config is NULL, BME280_RET_ILLEGAL on a value out of range,
+ *          BME280_RET_ERROR if sensor is not available or SPI fails
+ */
+BME280_Ret bme280_configure(const bme280_config_t* const config);
+
+/** Copy cached configuration. Mode stays forced after bme280_configure with BME280_MODE_FORCED
+ *  until sleep or normal mode is set, bme280_set_mode(BME280_MODE_FORCED) only starts a measurement. **/
+void bme280_get_configuration(bme280_config_t* const config);
+
 /**
  * Set mode of BME280: 
  *  - Sleep  (off)
@@ -215,6 +251,19 @@ BME280_Ret bme280_set_oversampling_press(uint8_t os);
  */
 BME280_Ret bme280_set_iir(uint8_t iir);
 
+/**
+ *  Low pass raw values in bme280_read_measurements, y += (x - y) / coefficient.
+ *  Takes BME280_IIR_OFF ... BME280_IIR_16 like bme280_set_iir, first read after setting initializes the filter.
+ *  Unlike hardware IIR, filters humidity too and is applied once per read, so read once per forced measurement.
+ */
+BME280_Ret bme280_set_software_iir(uint8_t iir);
+
+/**
+ *  Return maximum time of one measurement with current oversampling in microseconds.
+ *  Forced measurement is ready this long after bme280_set_mode(BME280_MODE_FORCED).
+ */
+uint32_t bme280_measurement_time_us(void);
+
 /**
  * Returns temperature in DegC, resolution is 0.01 DegC.
  * Output value of “2134” equals 21.34 DegC.
@@ -225,6 +274,7 @@ int32_t  bme280_get_temperature(void);
  * Returns pressure in Pa as unsigned 32 bit integer in Q24.8 format
  * (24 integer bits and 8 fractional bits).
  * Output value of “24674867” represents 24674867/256 = 96386.2 Pa = 963.862 hPa
+ * With BME280_PRESSURE_COMPENSATION_32BIT fractional bits are zero.
  */
 uint32_t bme280_get_pressure(void);
 
@@ -236,6 +286,9 @@ uint32_t bme280_get_pressure(void);
 uint32_t   bme280_get_humidity(void);
 
 // Used internally
+/** Pressure compensation variants in Q24.8, call bme280_get_temperature first to update t_fine **/
+uint32_t   bme280_compensate_P_int64(int32_t adc_P);
+uint32_t   bme280_compensate_P_int32(int32_t adc_P);
 uint8_t    bme280_read_reg(uint8_t reg);
 BME280_Ret bme280_read_burst(uint8_t start, uint8_t length, uint8_t* buffer);
 BME280_Ret bme280_write_reg(uint8_t reg, uint8_t value);
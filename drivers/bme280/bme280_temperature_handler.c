@@ -21,12 +21,22 @@ static message_handler p_flash_handler = NULL;
 static ruuvi_sensor_configuration_t m_configuration = {0};
 static ruuvi_endpoint_t m_destination_endpoint = PLAINTEXT_MESSAGE; //TODO: use something 
 
+/** Sensor is configured for forced measurements triggered by application **/
+static bool bme280_forced(void)
+{
+  bme280_config_t config;
+  bme280_get_configuration(&config);
+  return BME280_MODE_FORCED == config.mode;
+}
+
 //TODO: Add timer interrupt to sample rate to read samples 
 /**     This must be called as last function, as this function may bring BME280 out of sleep which prevents further configuration  **/
 static ret_code_t set_sample_rate(uint8_t sample_rate)
 {
   ret_code_t err_code = BME280_RET_OK;
   if(SAMPLE_RATE_NO_CHANGE == sample_rate) { return ENDPOINT_SUCCESS; }
+  // Application triggers forced measurements and would override the mode set here
+  if(bme280_forced()) { return ENDPOINT_NOT_SUPPORTED; }
   else if(SAMPLE_RATE_STOP == sample_rate)
   { 
     err_code |= bme280_set_mode(BME280_MODE_SLEEP); 
@@ -40,14 +50,17 @@ static ret_code_t set_sample_rate(uint8_t sample_rate)
     return err_code;
   }
   
-  //Round sample rate down.
-  if(sample_rate == 1){ err_code |= bme280_set_interval(BME280_STANDBY_1000_MS); }
-  else if(sample_rate == 2)  { err_code |= bme280_set_interval(BME280_STANDBY_500_MS); }
-  else if(sample_rate <= 8)  { err_code |= bme280_set_interval(BME280_STANDBY_125_MS); }
-  else if(sample_rate <= 16) { err_code |= bme280_set_interval(BME280_STANDBY_62_5_MS);}  
-  else if(sample_rate <= 200){ err_code |= bme280_set_interval(BME280_STANDBY_0_5_MS); }  
-  else { err_code |= BME280_RET_ILLEGAL; }
-	err_code |= bme280_set_mode(BME280_MODE_NORMAL);
+  //Round sample rate down. Interval and mode are written together, sensor may be running.
+  bme280_config_t config;
+  bme280_get_configuration(&config);
+  if(sample_rate == 1){ config.interval = BME280_STANDBY_1000_MS; }
+  else if(sample_rate == 2)  { config.interval = BME280_STANDBY_500_MS; }
+  else if(sample_rate <= 8)  { config.interval = BME280_STANDBY_125_MS; }
+  else if(sample_rate <= 16) { config.interval = BME280_STANDBY_62_5_MS;}  
+  else if(sample_rate <= 200){ config.interval = BME280_STANDBY_0_5_MS; }  
+  else { return BME280_RET_ILLEGAL; }
+  config.mode = BME280_MODE_NORMAL;
+  err_code |= bme280_configure(&config);
   if(BME280_RET_OK == err_code) { m_configuration.sample_rate = sample_rate; }
 	
 	return err_code;
@@ -151,7 +164,11 @@ static ret_code_t configure_sensor(const ruuvi_standard_message_t message)
   NRF_LOG_INFO("Configuring sensor:");
   NRF_LOG_HEXDUMP_INFO((uint8_t*)&(message.destination_endpoint), sizeof(message));
   NRF_LOG_INFO("\r\n");
-  bme280_set_mode(BME280_MODE_SLEEP); // Sleep sensor while configuring
+  // Forced mode sleeps between conversions, sleeping here would abort a conversion in progress
+  if(!bme280_forced())
+  {
+    bme280_set_mode(BME280_MODE_SLEEP); // Sleep sensor while configuring
+  }
                                       // TODO: Pass message to BME280 pressure, humidity handlers  
 
   //Return codes are truncated to 8 bits.
@@ -216,11 +216,16 @@ init_err_code_t init_bme280(void)
       return (BME280_RET_ERROR_SELFTEST == (BME280_Ret)err_code) ? INIT_ERR_SELFTEST : INIT_ERR_NO_RESPONSE;
     }
     //TODO: reset
-    bme280_set_mode(BME280_MODE_SLEEP); //Set sleep mode to allow configuration, sensor might have old config in internal RAM
-    err_code |= bme280_set_interval(BME280_STANDBY_1000_MS);
-    err_code |= bme280_set_oversampling_hum(BME280_OVERSAMPLING_1);
-    err_code |= bme280_set_oversampling_temp(BME280_OVERSAMPLING_1);
-    err_code |= bme280_set_oversampling_press(BME280_OVERSAMPLING_1);
+    //Sensor might have old config in internal RAM, configure stops it before writing
+    const bme280_config_t config = {
+      .os_hum   = BME280_OVERSAMPLING_1,
+      .os_temp  = BME280_OVERSAMPLING_1,
+      .os_press = BME280_OVERSAMPLING_1,
+      .iir      = BME280_IIR_OFF,
+      .interval = BME280_STANDBY_1000_MS,
+      .mode     = BME280_MODE_SLEEP
+    };
+    err_code |= bme280_configure(&config);
 
     if (BME280_RET_OK == (BME280_Ret)err_code)
     {
@@ -25,6 +25,7 @@ For a detailed description see the detailed description in @ref LIS2DH12.h
 #include "bsp.h"
 #include "boards.h"
 #include "init.h" //Timer ticks - todo: refactor
+#include "profiler.h"
 
 #define NRF_LOG_MODULE_NAME "LIS2DH12"
 #include "nrf_log.h"
@@ -44,19 +45,60 @@ For a detailed description see the detailed description in @ref LIS2DH12.h
 /** Bit Mask to enable auto address incrementation for multi read */
 #define SPI_ADR_INC 0x40U
 
+/** Maximum number of bytes in one register write, i.e. control register block **/
+#define WRITE_MAX 16U
+
+/** Maximum number of bytes in one register read, limited by EasyDMA transfer length **/
+#define READ_MAX 255U
+
+/** Address range covered by register shadow, CTRL_REG1 ... ACT_DUR, one dirty bit each **/
+#define SHADOW_FIRST LIS2DH12_CTRL_REG1
+#define SHADOW_LAST  LIS2DH12_ACT_DUR
+#define SHADOW_SIZE  (SHADOW_LAST - SHADOW_FIRST + 1U)
+
 /* MACROS *****************************************************************************************/
 
 
 /* PROTOTYPES *************************************************************************************/
 static lis2dh12_ret_t selftest(void);
 void timer_lis2dh12_event_handler(void* p_context);
-static int16_t rawToMg(int16_t raw_acceleration);
+static inline int16_t rawToMg(int16_t raw_acceleration, uint8_t shift, int16_t multiplier);
+static void update_conversion(void);
 static uint8_t scale_interrupt_threshold(int16_t threshold_mg);
+static bool is_shadowed(uint8_t address);
+static lis2dh12_ret_t shadow_load(void);
+static lis2dh12_ret_t shadow_get(uint8_t address, uint8_t* value);
+static lis2dh12_ret_t shadow_set(uint8_t address, uint8_t value);
+static void shadow_written(uint8_t address, const uint8_t* data, size_t count);
 
 /* VARIABLES **************************************************************************************/
 static lis2dh12_scale_t      state_scale = LIS2DH12_SCALE16G;
 static lis2dh12_resolution_t state_resolution = LIS2DH12_RES10BIT;
 
+/** Raw to mg conversion for state_scale and state_resolution: mg = (raw / 2^shift) * multiplier **/
+typedef struct
+{
+  uint8_t shift;
+  int16_t multiplier;
+}conversion_t;
+static conversion_t m_conversion = { .shift = LIS2DH12_RES10BIT, .multiplier = 48 }; // 16 G, 10 bit
+
+/** SPI transmit buffer for address and data to write. Static to keep it in RAM for EasyDMA and off the heap **/
+static uint8_t m_spi_scratch[1 + WRITE_MAX];
+
+/** 
+ * Copy of CTRL_REG1..6, FIFO_CTRL_REG, INTx_CFG, ACT_THS and ACT_DUR, indexed by address - SHADOW_FIRST. 
+ * Other registers in range are not shadowed. Setters modify the copy and write it, so configuration
+ * changes do not need to read the sensor.
+ **/
+static uint8_t  m_shadow[SHADOW_SIZE];
+static uint32_t m_shadow_dirty    = 0;     // Bit per shadow index, changed but not written while deferred
+static bool     m_shadow_valid    = false; // Shadow matches sensor
+static bool     m_shadow_deferred = false; // Setters only modify shadow until lis2dh12_apply_config
+
+static uint32_t m_inactivity_duration_ms = 0; // Sleep-to-wake duration, 0 if disabled. ACT_DUR follows sample rate.
+static lis2dh12_ret_t write_inactivity_duration(lis2dh12_sample_rate_t sample_rate);
+
 
 
 /**
@@ -76,6 +118,9 @@ lis2dh12_ret_t lis2dh12_init(void)
     /* Start Selftest */
     err_code |= selftest();
 
+    /* Cache configuration registers */
+    err_code |= shadow_load();
+
     return err_code;
 }
 
@@ -107,9 +152,58 @@ lis2dh12_ret_t lis2dh12_reset(void)
   err_code |= lis2dh12_write_register(0x3D, &ctrl[1], 1);
   err_code |= lis2dh12_write_register(0x3E, &ctrl[1], 1);
   err_code |= lis2dh12_write_register(0x3F, &ctrl[1], 1);
+  // All shadowed registers were written above
+  m_shadow_valid = (LIS2DH12_RET_OK == err_code);
+  m_shadow_dirty = 0;
+  m_inactivity_duration_ms = 0; // CTRL_REG6 P2_ACT is cleared
  return err_code;
 }
 
+/**
+ *  Defer configuration writes. Setters modify only the register shadow until lis2dh12_apply_config is called.
+ */
+lis2dh12_ret_t lis2dh12_begin_config(void)
+{
+    lis2dh12_ret_t err_code = LIS2DH12_RET_OK;
+    if(!m_shadow_valid) { err_code |= shadow_load(); }
+    // Deferred setters would modify a stale copy which apply_config writes out in full
+    if(LIS2DH12_RET_OK != err_code) { return err_code; }
+    m_shadow_deferred = true;
+    return err_code;
+}
+
+/**
+ *  Write configuration changed since lis2dh12_begin_config. Changed CTRL_REG1..6 are written
+ *  in one auto-increment transaction before FIFO_CTRL_REG, INTx_CFG, ACT_THS and ACT_DUR, so FIFO
+ *  is enabled before FIFO mode is set.
+ */
+lis2dh12_ret_t lis2dh12_apply_config(void)
+{
+    lis2dh12_ret_t err_code = LIS2DH12_RET_OK;
+    m_shadow_deferred = false;
+    const uint8_t ctrl_count = LIS2DH12_CTRL_REG6 - SHADOW_FIRST + 1U;
+    uint8_t first = ctrl_count;
+    uint8_t last  = 0;
+    // Span of changed control registers, unchanged registers between changed ones are rewritten
+    for(uint8_t ii = 0; ii < ctrl_count; ii++)
+    {
+      if(!(m_shadow_dirty & (1UL << ii))) { continue; }
+      if(first == ctrl_count) { first = ii; }
+      last = ii;
+    }
+    if(first < ctrl_count)
+    {
+      err_code |= lis2dh12_write_register(SHADOW_FIRST + first, &m_shadow[first], last - first + 1U);
+    }
+    for(uint8_t ii = ctrl_count; ii < SHADOW_SIZE; ii++)
+    {
+      if(!(m_shadow_dirty & (1UL << ii))) { continue; }
+      err_code |= lis2dh12_write_register(SHADOW_FIRST + ii, &m_shadow[ii], 1);
+    }
+    m_shadow_dirty = 0;
+    return err_code;
+}
+
 /**
  *  Enables X-Y-Z axes
  */
@@ -117,9 +211,7 @@ lis2dh12_ret_t lis2dh12_enable(void)
 {
     lis2dh12_ret_t err_code = LIS2DH12_RET_OK;
     /* Enable XYZ axes */
-    uint8_t ctrl[1] = {0};
-    ctrl[0] = LIS2DH12_XYZ_EN_MASK;
-    err_code |= lis2dh12_write_register(LIS2DH12_CTRL_REG1, ctrl, 1);
+    err_code |= shadow_set(LIS2DH12_CTRL_REG1, LIS2DH12_XYZ_EN_MASK);
     return err_code;
 }
 
@@ -129,15 +221,15 @@ lis2dh12_ret_t lis2dh12_enable(void)
 lis2dh12_ret_t lis2dh12_set_scale(lis2dh12_scale_t scale)
 {
     lis2dh12_ret_t err_code = LIS2DH12_RET_OK;
-    //Read current value of CTRL4 Register
+    //Current value of CTRL4 Register
     uint8_t ctrl4[1] = {0};
-    err_code |= lis2dh12_read_register(LIS2DH12_CTRL_REG4, ctrl4, 1);
+    err_code |= shadow_get(LIS2DH12_CTRL_REG4, ctrl4);
     //Reset scale bits
     ctrl4[0] &= ~LIS2DH12_FS_MASK;
     ctrl4[0] |= scale;
     //Write register value back to lis2dh12
-    err_code |= lis2dh12_write_register(LIS2DH12_CTRL_REG4, ctrl4, 1);
-    if(LIS2DH12_RET_OK == err_code){ state_scale = scale; }
+    err_code |= shadow_set(LIS2DH12_CTRL_REG4, ctrl4[0]);
+    if(LIS2DH12_RET_OK == err_code){ state_scale = scale; update_conversion(); }
     return err_code;
 }
 
@@ -168,9 +260,9 @@ lis2dh12_ret_t lis2dh12_set_resolution(lis2dh12_resolution_t resolution)
     lis2dh12_ret_t err_code = LIS2DH12_RET_OK;
     uint8_t ctrl1[1] = {0};
     uint8_t ctrl4[1] = {0};
-    //Read registers 3 & 4
-    err_code |= lis2dh12_read_register(LIS2DH12_CTRL_REG1, ctrl1, 1);
-    err_code |= lis2dh12_read_register(LIS2DH12_CTRL_REG4, ctrl4, 1);
+    //Registers 1 & 4
+    err_code |= shadow_get(LIS2DH12_CTRL_REG1, ctrl1);
+    err_code |= shadow_get(LIS2DH12_CTRL_REG4, ctrl4);
     //Reset Low-power, high-resolution masks
     ctrl1[0] &= ~LIS2DH12_LPEN_MASK;
     ctrl4[0] &= ~LIS2DH12_HR_MASK;
@@ -192,9 +284,9 @@ lis2dh12_ret_t lis2dh12_set_resolution(lis2dh12_resolution_t resolution)
              err_code |= LIS2DH12_RET_INVALID;
              break;
     }
-    err_code |= lis2dh12_write_register(LIS2DH12_CTRL_REG1, ctrl1, 1);
-    err_code |= lis2dh12_write_register(LIS2DH12_CTRL_REG4, ctrl4, 1);
-    if(LIS2DH12_RET_OK == err_code){ state_resolution = resolution; }    
+    err_code |= shadow_set(LIS2DH12_CTRL_REG1, ctrl1[0]);
+    err_code |= shadow_set(LIS2DH12_CTRL_REG4, ctrl4[0]);
+    if(LIS2DH12_RET_OK == err_code){ state_resolution = resolution; update_conversion(); }
     return err_code;
 }
 
@@ -209,14 +301,16 @@ lis2dh12_ret_t lis2dh12_set_sample_rate(lis2dh12_sample_rate_t sample_rate)
 {
     lis2dh12_ret_t err_code = LIS2DH12_RET_OK;
     uint8_t ctrl[1] = {0};
-    err_code |= lis2dh12_read_register(LIS2DH12_CTRL_REG1, ctrl, 1);
+    err_code |= shadow_get(LIS2DH12_CTRL_REG1, ctrl);
     NRF_LOG_DEBUG("Read samplerate %x, status %d\r\n", ctrl[0], err_code);
     // Clear sample rate bits
     ctrl[0] &= ~LIS2DH12_ODR_MASK;
     // Setup sample rate
     ctrl[0] |= sample_rate;
-    err_code |= lis2dh12_write_register(LIS2DH12_CTRL_REG1, ctrl, 1);
+    err_code |= shadow_set(LIS2DH12_CTRL_REG1, ctrl[0]);
     NRF_LOG_DEBUG("Wrote samplerate %x, status %d\r\n", ctrl[0], err_code);
+    // Inactivity duration is counted in samples of configured rate
+    if(m_inactivity_duration_ms) { err_code |= write_inactivity_duration(sample_rate); }
 
     //Always read REFERENCE register when powering down to reset filter.
     if(LIS2DH12_RATE_0 == sample_rate)
@@ -233,7 +327,7 @@ lis2dh12_ret_t lis2dh12_get_sample_rate(lis2dh12_sample_rate_t *sample_rate)
 {
     lis2dh12_ret_t err_code = LIS2DH12_RET_OK;
     uint8_t ctrl[1] = {0};
-    err_code |= lis2dh12_read_register(LIS2DH12_CTRL_REG1, ctrl, 1);
+    err_code |= shadow_get(LIS2DH12_CTRL_REG1, ctrl);
     NRF_LOG_DEBUG("Read samplerate %x, status %d\r\n", ctrl[0], err_code);
     ctrl[0] &= LIS2DH12_ODR_MASK;
     *sample_rate = ctrl[0];
@@ -274,8 +368,8 @@ lis2dh12_ret_t lis2dh12_set_fifo_mode(lis2dh12_fifo_mode_t mode)
     uint8_t ctrl_fifo[1] = {0};
     uint8_t ctrl5[1] = {0};
 
-    err_code |= lis2dh12_read_register(LIS2DH12_CTRL_REG5, ctrl5, 1);
-    err_code |= lis2dh12_read_register(LIS2DH12_FIFO_CTRL_REG, ctrl_fifo, 1);
+    err_code |= shadow_get(LIS2DH12_CTRL_REG5, ctrl5);
+    err_code |= shadow_get(LIS2DH12_FIFO_CTRL_REG, ctrl_fifo);
 
     // Clear FiFo bits
     ctrl_fifo[0] &= ~LIS2DH12_FM_MASK;
@@ -286,24 +380,28 @@ lis2dh12_ret_t lis2dh12_set_fifo_mode(lis2dh12_fifo_mode_t mode)
     //Enable FiFo if appropriate
     if(LIS2DH12_MODE_BYPASS != mode){ ctrl5[0] |= LIS2DH12_FIFO_EN_MASK; }
     //FIFO must be enabled before setting mode
-    err_code |= lis2dh12_write_register(LIS2DH12_CTRL_REG5, ctrl5, 1);
-    err_code |= lis2dh12_write_register(LIS2DH12_FIFO_CTRL_REG, ctrl_fifo, 1);
+    err_code |= shadow_set(LIS2DH12_CTRL_REG5, ctrl5[0]);
+    err_code |= shadow_set(LIS2DH12_FIFO_CTRL_REG, ctrl_fifo[0]);
     return err_code;
 }
 
 lis2dh12_ret_t lis2dh12_read_samples(lis2dh12_sensor_buffer_t* buffer, size_t count)
 {
+     PROFILER_BEGIN(PROFILER_LIS2DH12_READ_SAMPLES);
      lis2dh12_ret_t err_code = LIS2DH12_RET_OK;
      size_t bytes_to_read = count*sizeof(lis2dh12_sensor_buffer_t);
      NRF_LOG_DEBUG("Reading %d bytes \r\n", bytes_to_read);
      err_code |= lis2dh12_read_register(LIS2DH12_OUT_X_L, (uint8_t*)buffer, count*sizeof(lis2dh12_sensor_buffer_t));
-     // Use constant bitshift, so we don't have to adjust mgpb with resolution
-     for(int ii = 0; ii < count; ii++)
+     // Descriptor is loaded once, loop body is the same for every scale and resolution
+     const uint8_t shift = m_conversion.shift;
+     const int16_t multiplier = m_conversion.multiplier;
+     for(size_t ii = 0; ii < count; ii++)
      {
-        buffer[ii].sensor.x = rawToMg(buffer[ii].sensor.x);
-        buffer[ii].sensor.y = rawToMg(buffer[ii].sensor.y);
-        buffer[ii].sensor.z = rawToMg(buffer[ii].sensor.z);
+        buffer[ii].sensor.x = rawToMg(buffer[ii].sensor.x, shift, multiplier);
+        buffer[ii].sensor.y = rawToMg(buffer[ii].sensor.y, shift, multiplier);
+        buffer[ii].sensor.z = rawToMg(buffer[ii].sensor.z, shift, multiplier);
      }
+     PROFILER_END(PROFILER_LIS2DH12_READ_SAMPLES);
      return err_code;
 }
 
@@ -317,16 +415,33 @@ lis2dh12_ret_t lis2dh12_get_fifo_sample_number(size_t* count)
     return err_code;
 }
 
+/**
+ *  Select INT pin whose interrupt signal switches Stream-to-FIFO mode to FIFO mode.
+ *
+ *  @param pin 1 or 2, others are invalid
+ */
+lis2dh12_ret_t lis2dh12_set_fifo_trigger(uint8_t pin)
+{
+    if(1 != pin && 2 != pin){ return LIS2DH12_RET_INVALID; }
+    lis2dh12_ret_t err_code = LIS2DH12_RET_OK;
+    uint8_t ctrl[1] = {0};
+    err_code |= shadow_get(LIS2DH12_FIFO_CTRL_REG, ctrl);
+    ctrl[0] &= ~LIS2DH12_TR_MASK;
+    if(2 == pin) { ctrl[0] |= LIS2DH12_TR_MASK; }
+    err_code |= shadow_set(LIS2DH12_FIFO_CTRL_REG, ctrl[0]);
+    return err_code;
+}
+
 // Generate watermark interrupt when FIFO reaches certain level
 lis2dh12_ret_t lis2dh12_set_fifo_watermark(size_t count)
 {
     if(count > 32) return LIS2DH12_RET_INVALID;
     lis2dh12_ret_t err_code = LIS2DH12_RET_OK;
     uint8_t ctrl[1] = {0};
-    err_code |= lis2dh12_read_register(LIS2DH12_FIFO_CTRL_REG, ctrl, 1);
+    err_code |= shadow_get(LIS2DH12_FIFO_CTRL_REG, ctrl);
     ctrl[0] &= ~LIS2DH12_FTH_MASK;
     ctrl[0] += count;
-    err_code |= lis2dh12_write_register(LIS2DH12_FIFO_CTRL_REG, ctrl, 1);
+    err_code |= shadow_set(LIS2DH12_FIFO_CTRL_REG, ctrl[0]);
     return err_code;
 }
 
@@ -343,9 +458,9 @@ lis2dh12_ret_t lis2dh12_set_activity_interrupt_pin_2(uint16_t mg)
     // //CTRLREG2 = 0x02
     // ctrl[0] = LIS2DH12_HPIS2_MASK;
     // lis2dh12_write_register(LIS2DH12_CTRL_REG2, ctrl, 1);
-    lis2dh12_read_register(LIS2DH12_CTRL_REG2, &cfg, 1);
+    shadow_get(LIS2DH12_CTRL_REG2, &cfg);
     cfg |= LIS2DH12_HPIS2_MASK;
-    lis2dh12_write_register(LIS2DH12_CTRL_REG2, &cfg, 1);
+    shadow_set(LIS2DH12_CTRL_REG2, cfg);
 
     // Enable interrupt 2 on X-Y-Z HI/LO.
     // INT2_CFG = 0x7F
@@ -385,11 +500,9 @@ lis2dh12_ret_t lis2dh12_set_activity_interrupt_pin_2(uint16_t mg)
 lis2dh12_ret_t lis2dh12_set_interrupts(uint8_t interrupts, uint8_t function)
 {
   if(1 != function && 2 != function){ return LIS2DH12_RET_INVALID; }
-  uint8_t ctrl[1]; 
-  ctrl[0] = interrupts;
   uint8_t target_reg = LIS2DH12_CTRL_REG3;
   if( 2 == function ) { target_reg = LIS2DH12_CTRL_REG6; }
-  return lis2dh12_write_register(target_reg, ctrl, 1);
+  return shadow_set(target_reg, interrupts);
 }
 
 /**
@@ -403,11 +516,9 @@ lis2dh12_ret_t lis2dh12_set_interrupts(uint8_t interrupts, uint8_t function)
 lis2dh12_ret_t lis2dh12_set_interrupt_configuration(uint8_t cfg, uint8_t function)
 {
   if(1 != function && 2 != function){ return LIS2DH12_RET_INVALID; }
-  uint8_t ctrl[1]; 
-  ctrl[0] = cfg;
   uint8_t target_reg = LIS2DH12_INT1_CFG;
   if( 2 == function ) { target_reg = LIS2DH12_INT2_CFG; }
-  return lis2dh12_write_register(target_reg, ctrl, 1);
+  return shadow_set(target_reg, cfg);
 }
 
 /**
@@ -428,6 +539,66 @@ lis2dh12_ret_t lis2dh12_set_threshold(uint8_t bits, uint8_t pin)
   return lis2dh12_write_register(target_reg, ctrl, 1);
 }
 
+/**
+ *  Setup sleep-to-wake threshold, ACT_THS. LSB is 16 mg at 2 G scale, 32 mg at 4 G, 62 mg at 8 G and 186 mg at 16 G.
+ *
+ *  @param bits number of LSBs, 0 ... 0x7F
+ *
+ *  @return error code from stack
+ */
+lis2dh12_ret_t lis2dh12_set_activity_threshold(uint8_t bits)
+{
+  if(bits > LIS2DH12_ACTH_MASK){ return LIS2DH12_RET_INVALID; }
+  return shadow_set(LIS2DH12_ACT_THS, bits);
+}
+
+/**
+ * Configure sleep-to-wake. After acceleration stays below threshold for duration, LIS2DH12 drops to 10 Hz low-power mode
+ * by itself and returns to configured sample rate and mode once threshold is exceeded. Inactivity is signaled on INT2
+ * pin, which is high while the sensor sleeps. Other interrupts routed to INT2 are left enabled and share the pin.
+ *
+ * Duration is counted at the configured sample rate, lis2dh12_set_sample_rate rewrites it. One ACT_DUR step is 8 samples.
+ *
+ * @param threshold_mg acceleration threshold, 0 disables sleep-to-wake and its INT2 signal.
+ * @param duration_ms time below threshold before sleeping, rounded down to (8 * ACT_DUR + 1) samples.
+ *
+ * @return error code from SPI
+ */
+lis2dh12_ret_t lis2dh12_set_sleep_to_wake(uint16_t threshold_mg, uint32_t duration_ms)
+{
+  lis2dh12_ret_t err_code = LIS2DH12_RET_OK;
+  lis2dh12_sample_rate_t sample_rate = LIS2DH12_RATE_0;
+  uint8_t ctrl6 = 0;
+  uint8_t threshold = 0;
+
+  if(threshold_mg)
+  {
+    threshold = scale_interrupt_threshold(threshold_mg);
+    err_code |= lis2dh12_get_sample_rate(&sample_rate);
+  }
+  // At least 1 ms keeps duration tracked, ACT_DUR is rewritten on every sample rate change
+  m_inactivity_duration_ms = threshold_mg ? (duration_ms ? duration_ms : 1) : 0;
+  err_code |= write_inactivity_duration(sample_rate);
+  err_code |= lis2dh12_set_activity_threshold(threshold);
+
+  err_code |= shadow_get(LIS2DH12_CTRL_REG6, &ctrl6);
+  ctrl6 &= ~LIS2DH12_P2_ACT_MASK;
+  if(threshold) { ctrl6 |= LIS2DH12_P2_ACT_MASK; }
+  err_code |= shadow_set(LIS2DH12_CTRL_REG6, ctrl6);
+  return err_code;
+}
+
+/**
+ * Write ACT_DUR for sleep-to-wake duration at given sample rate, 8 samples per step.
+ */
+static lis2dh12_ret_t write_inactivity_duration(lis2dh12_sample_rate_t sample_rate)
+{
+  uint32_t samples = (m_inactivity_duration_ms * lis2dh12_odr_to_hz(sample_rate)) / 1000;
+  uint32_t steps = samples ? (samples - 1) / 8 : 0;
+  uint8_t duration = (steps > 0xFF) ? 0xFF : steps;
+  return shadow_set(LIS2DH12_ACT_DUR, duration);
+}
+
 /**
  * Enable tap detection interrupt with click_cfg, threshold, time limit,
  * window, latency and interrupt pin (1 or 2).
@@ -442,29 +613,35 @@ lis2dh12_ret_t lis2dh12_set_threshold(uint8_t bits, uint8_t pin)
  * These parameters detect double taps well (no false positives on moving,
  * reliable detection) on Ruuvitag with LIS2DH12 data rate set to 400 Hz:
  * lis2dh12_set_tap_interrupt(LIS2DH12_ZD_MASK, 1000, 100, 100, 400, 1)
+ *
+ * Click interrupt is added to interrupts already routed to the pin.
+ * Time limit, latency and window are counted at current sample rate, set sample rate first.
  */
 lis2dh12_ret_t lis2dh12_set_tap_interrupt(uint8_t click_cfg, int threshold_mg, int timelimit_ms, int latency_ms, int window_ms, uint8_t pin)
 {
     int reg;
     uint8_t value;
+    uint8_t click;
     lis2dh12_sample_rate_t sample_rate;
     lis2dh12_ret_t err_code = LIS2DH12_RET_OK;
 
     if (pin == 1) {
-        value = LIS2DH12_I1_CLICK;
+        click = LIS2DH12_I1_CLICK;
+        err_code |= shadow_get(LIS2DH12_CTRL_REG3, &value);
     } else if (pin == 2) {
-        value = LIS2DH12_I2C_CCK_EN_MASK;
+        click = LIS2DH12_I2C_CCK_EN_MASK;
+        err_code |= shadow_get(LIS2DH12_CTRL_REG6, &value);
     } else {
         return LIS2DH12_RET_INVALID;
     }
     /* Enable click interrupt on pin */
-    err_code |= lis2dh12_set_interrupts(value, pin);
+    err_code |= lis2dh12_set_interrupts(value | click, pin);
 
     /* Turn on high pass filter for click detection */
-    err_code |= lis2dh12_read_register(LIS2DH12_CTRL_REG2, &value, 1);
+    err_code |= shadow_get(LIS2DH12_CTRL_REG2, &value);
     value |= LIS2DH12_HPCLICK_MASK;
     value &= ~LIS2DH12_HPCF_MASK; // Largest highpass cutoff frequency
-    err_code |= lis2dh12_write_register(LIS2DH12_CTRL_REG2, &value, 1);
+    err_code |= shadow_set(LIS2DH12_CTRL_REG2, value);
 
     value = click_cfg;
     err_code |= lis2dh12_write_register(LIS2DH12_CLICK_CFG, &value, 1);
@@ -514,150 +691,39 @@ static lis2dh12_ret_t selftest(void)
 }
 
 /**
- * Conversion functions from 
+ * Digit sizes from 
  * https://github.com/STMicroelectronics/STMems_Standard_C_drivers/blob/3e3b7528dfacb223aea250daf4e512e335f17509/lis2dh12_STdC/driver/lis2dh12_reg.c#L104
+ * mg per digit at 12-bit resolution, indexed by scale bits of CTRL_REG4. Each 2 bits less resolution
+ * multiplies digit size by 4.
  */
-static inline int16_t lis2dh12_from_fs2_hr_to_mg(int16_t lsb)
-{
-  return (lsb / 16 ) * 1;
-}
-
-static inline int16_t lis2dh12_from_fs4_hr_to_mg(int16_t lsb)
-{
-  return (lsb / 16 ) * 2;
-}
-
-static inline int16_t lis2dh12_from_fs8_hr_to_mg(int16_t lsb)
-{
-  return (lsb / 16 ) * 4;
-}
-
-static inline int16_t lis2dh12_from_fs16_hr_to_mg(int16_t lsb)
-{
-  return (lsb / 16) * 12;
-}
-
-static inline int16_t lis2dh12_from_fs2_nm_to_mg(int16_t lsb)
-{
-  return (lsb / 64) * 4;
-}
-
-static inline int16_t lis2dh12_from_fs4_nm_to_mg(int16_t lsb)
-{
-  return (lsb / 64) * 8;
-}
-
-static inline int16_t lis2dh12_from_fs8_nm_to_mg(int16_t lsb)
-{
-  return (lsb / 64) * 16;
-}
-
-static inline int16_t lis2dh12_from_fs16_nm_to_mg(int16_t lsb)
-{
-  return (lsb / 64) * 48;
-}
-
-static inline int16_t lis2dh12_from_fs2_lp_to_mg(int16_t lsb)
-{
-  return (lsb / 256) * 16;
-}
-
-static inline int16_t lis2dh12_from_fs4_lp_to_mg(int16_t lsb)
-{
-  return (lsb / 256) * 32;
-}
-
-static inline int16_t lis2dh12_from_fs8_lp_to_mg(int16_t lsb)
-{
-  return (lsb / 256) * 64;
-}
+static const uint8_t m_hr_mg_per_digit[] = { 1, 2, 4, 12 };
 
-static inline int16_t lis2dh12_from_fs16_lp_to_mg(int16_t lsb)
+/**
+ * Update conversion descriptor after scale or resolution change.
+ * Resolution enum value is the number of unused low bits in the left-justified output.
+ */
+static void update_conversion(void)
 {
-  return (lsb / 256) * 192;
+  uint8_t scale_index = (state_scale & LIS2DH12_FS_MASK) >> 4;
+  m_conversion.shift = state_resolution;
+  m_conversion.multiplier = m_hr_mg_per_digit[scale_index] << (state_resolution - LIS2DH12_RES12BIT);
 }
 
-
 /**
- * Convert raw value to acceleration in mg. Reads scale and resolution from state variables.
+ * Convert raw value to acceleration in mg with current descriptor.
+ * Division rounds towards zero like the original per-mode conversions, i.e. negative values are biased
+ * before arithmetic shift.
  *
  * @param raw_acceleration raw ADC value from LIS2DH12
+ * @param shift digits are raw_acceleration >> shift
+ * @param multiplier mg per digit
  * @return int16_t representing acceleration in milli-G. 
  */
-static int16_t rawToMg(int16_t raw_acceleration)
+static inline int16_t rawToMg(int16_t raw_acceleration, uint8_t shift, int16_t multiplier)
 {
-  switch(state_scale)
-  {
-    case LIS2DH12_SCALE2G:
-      switch(state_resolution)
-      {
-        case LIS2DH12_RES8BIT:
-          return lis2dh12_from_fs2_lp_to_mg(raw_acceleration);
-
-        case LIS2DH12_RES10BIT:
-          return  lis2dh12_from_fs2_nm_to_mg(raw_acceleration);
-
-        case LIS2DH12_RES12BIT:
-          return  lis2dh12_from_fs2_hr_to_mg(raw_acceleration);
-
-        default:
-          break;
-      }
-      break;
-
-    case LIS2DH12_SCALE4G:
-      switch(state_resolution)
-      {
-        case LIS2DH12_RES8BIT:
-          return  lis2dh12_from_fs4_lp_to_mg(raw_acceleration);
-
-        case LIS2DH12_RES10BIT:
-          return  lis2dh12_from_fs4_nm_to_mg(raw_acceleration);
-
-        case LIS2DH12_RES12BIT:
-          return  lis2dh12_from_fs4_hr_to_mg(raw_acceleration);
-      }
-      break;
-
-    case LIS2DH12_SCALE8G:
-      switch(state_resolution)
-      {
-        case LIS2DH12_RES8BIT:
-          return  lis2dh12_from_fs8_lp_to_mg(raw_acceleration);
-
-        case LIS2DH12_RES10BIT:
-          return  lis2dh12_from_fs8_nm_to_mg(raw_acceleration);
-
-        case LIS2DH12_RES12BIT:
-          return  lis2dh12_from_fs8_hr_to_mg(raw_acceleration);
-
-        default:
-          break;
-      }
-    break;
-
-    case LIS2DH12_SCALE16G:
-      switch(state_resolution)
-      {
-        case LIS2DH12_RES8BIT:
-          return  lis2dh12_from_fs16_lp_to_mg(raw_acceleration);
-
-        case LIS2DH12_RES10BIT:
-          return  lis2dh12_from_fs16_nm_to_mg(raw_acceleration);
-
-        case LIS2DH12_RES12BIT:
-          return  lis2dh12_from_fs16_hr_to_mg(raw_acceleration);
-
-        default:
-          break;
-      }
-    break;
-
-    default:
-      break;
-  }
-  // reached only in case of an error, return "smallest representable value"
-  return 0x8000;
+  int32_t raw  = raw_acceleration;
+  int32_t bias = (raw >> 31) & ((1 << shift) - 1);
+  return (int16_t)(((raw + bias) >> shift) * multiplier);
 }
 
 /**
@@ -713,37 +779,33 @@ static uint8_t scale_interrupt_threshold(int16_t threshold_mg)
  * @param[out] p_toRead Pointer to result buffer
  * @param[in] cound Number of bytes to read
  *
+ * Address byte is sent from driver scratch and data is received directly into p_toRead,
+ * which must be in RAM.
+ *
  * @return LIS2DH12_RET_OK No Error
  * @return LIS2DH12_RET_NULL Result buffer is NULL Pointer
+ * @return LIS2DH12_RET_INVALID Count is larger than one transfer allows
  * @return LIS2DH12_RET_ERROR Read attempt was not successful
  */
 lis2dh12_ret_t lis2dh12_read_register(const uint8_t address, uint8_t* const p_toRead, const size_t count)
 {
     NRF_LOG_DEBUG("LIS2DH12 Register read started'\r\n");
     lis2dh12_ret_t err_code = LIS2DH12_RET_OK;
-    uint8_t* write_buffer   = calloc(count+1, sizeof(uint8_t));
-    //Separate buffer to read data, includes room for response to address byte. 
-    //This is pretty ineficient, TODO
-    uint8_t* read_buffer    = calloc(count+1, sizeof(uint8_t));
 
     if (NULL == p_toRead)
     {
         err_code |= LIS2DH12_RET_NULL;
     }
+    else if (count > READ_MAX)
+    {
+        err_code |= LIS2DH12_RET_INVALID;
+    }
     else
     {
-        write_buffer[0] = address | SPI_READ | SPI_ADR_INC;
-        err_code |= spi_transfer_lis2dh12(write_buffer, (count + 1U), read_buffer);
-
-        if (SPI_RET_OK == (SPI_Ret)err_code)
-        {
-            /* Transfer was ok, copy result */
-            memcpy(p_toRead, &(read_buffer[1]), count);
-        }
+        m_spi_scratch[0] = address | SPI_READ | SPI_ADR_INC;
+        err_code |= spi_read_lis2dh12(m_spi_scratch, count, p_toRead);
     }
     NRF_LOG_DEBUG("LIS2DH12 Register read complete'\r\n");
-    free(read_buffer);
-    free(write_buffer);
     return err_code;
 }
 
@@ -754,25 +816,108 @@ lis2dh12_ret_t lis2dh12_read_register(const uint8_t address, uint8_t* const p_to
  * @param[in] dataToWrite Data to write to register
  *
  * @return LIS2DH12_RET_OK No Error
+ * @return LIS2DH12_RET_NULL Data is NULL Pointer
+ * @return LIS2DH12_RET_INVALID Count is larger than WRITE_MAX
  * @return LIS2DH12_RET_ERROR Address is lager than allowed
  */
 lis2dh12_ret_t lis2dh12_write_register(uint8_t address, uint8_t* const dataToWrite, size_t count)
 {
     lis2dh12_ret_t err_code = LIS2DH12_RET_OK;
-    uint8_t* to_read  = calloc(count+1, sizeof(uint8_t)); /* dummy, not used for writing */
-    uint8_t* to_write = calloc(count+1, sizeof(uint8_t));
 
+    if (NULL == dataToWrite)
+    {
+        err_code |= LIS2DH12_RET_NULL;
+    }
+    else if (count > WRITE_MAX)
+    {
+        err_code |= LIS2DH12_RET_INVALID;
+    }
     /* SPI Addresses are 5bit only */
-    if (address <= ADR_MAX)
+    else if (address <= ADR_MAX)
     {
-        to_write[0] = address;
-        memcpy(&(to_write[1]), dataToWrite, count);
+        m_spi_scratch[0] = address;
+
+        /* Multi-byte writes fill consecutive registers */
+        if (count > 1) { m_spi_scratch[0] |= SPI_ADR_INC; }
+        memcpy(&(m_spi_scratch[1]), dataToWrite, count);
 
-        err_code |= spi_transfer_lis2dh12(to_write, (count+1), to_read);
+        /* Nothing to receive, transfer is transmit only */
+        err_code |= spi_transfer_lis2dh12(m_spi_scratch, (count+1), NULL);
+        if (LIS2DH12_RET_OK == err_code) { shadow_written(address, dataToWrite, count); }
+        else { m_shadow_valid = false; }
     }
-    free(to_read);
-    free(to_write);
 
     return err_code;
 }
 
+/** Shadowed registers within SHADOW_FIRST ... SHADOW_LAST **/
+static bool is_shadowed(uint8_t address)
+{
+    return (address >= LIS2DH12_CTRL_REG1 && address <= LIS2DH12_CTRL_REG6) ||
+           LIS2DH12_FIFO_CTRL_REG == address ||
+           LIS2DH12_INT1_CFG == address ||
+           LIS2DH12_INT2_CFG == address ||
+           LIS2DH12_ACT_THS == address ||
+           LIS2DH12_ACT_DUR == address;
+}
+
+/**
+ * Read shadowed registers from sensor, CTRL_REG1..6 in one transaction.
+ */
+static lis2dh12_ret_t shadow_load(void)
+{
+    lis2dh12_ret_t err_code = LIS2DH12_RET_OK;
+    err_code |= lis2dh12_read_register(LIS2DH12_CTRL_REG1, &m_shadow[0], LIS2DH12_CTRL_REG6 - LIS2DH12_CTRL_REG1 + 1);
+    err_code |= lis2dh12_read_register(LIS2DH12_FIFO_CTRL_REG, &m_shadow[LIS2DH12_FIFO_CTRL_REG - SHADOW_FIRST], 1);
+    err_code |= lis2dh12_read_register(LIS2DH12_INT1_CFG, &m_shadow[LIS2DH12_INT1_CFG - SHADOW_FIRST], 1);
+    err_code |= lis2dh12_read_register(LIS2DH12_INT2_CFG, &m_shadow[LIS2DH12_INT2_CFG - SHADOW_FIRST], 1);
+    err_code |= lis2dh12_read_register(LIS2DH12_ACT_THS, &m_shadow[LIS2DH12_ACT_THS - SHADOW_FIRST], 2);
+    m_shadow[LIS2DH12_CTRL_REG5 - SHADOW_FIRST] &= ~LIS2DH12_BOOT_MASK;
+    m_shadow_valid = (LIS2DH12_RET_OK == err_code);
+    m_shadow_dirty = 0;
+    return err_code;
+}
+
+/**
+ * Get shadowed register value, loading shadow from sensor if it is not valid.
+ */
+static lis2dh12_ret_t shadow_get(uint8_t address, uint8_t* value)
+{
+    lis2dh12_ret_t err_code = LIS2DH12_RET_OK;
+    if(!is_shadowed(address)) { return LIS2DH12_RET_INVALID; }
+    if(!m_shadow_valid && !m_shadow_deferred) { err_code |= shadow_load(); }
+    *value = m_shadow[address - SHADOW_FIRST];
+    return err_code;
+}
+
+/**
+ * Set shadowed register value and write it to sensor, or mark it changed if writes are deferred.
+ */
+static lis2dh12_ret_t shadow_set(uint8_t address, uint8_t value)
+{
+    if(!is_shadowed(address)) { return LIS2DH12_RET_INVALID; }
+    if(m_shadow_deferred)
+    {
+      m_shadow[address - SHADOW_FIRST] = value;
+      m_shadow_dirty |= 1UL << (address - SHADOW_FIRST);
+      return LIS2DH12_RET_OK;
+    }
+    return lis2dh12_write_register(address, &value, 1);
+}
+
+/**
+ * Update shadow after successful write of count registers starting from address.
+ */
+static void shadow_written(uint8_t address, const uint8_t* data, size_t count)
+{
+    for(size_t ii = 0; ii < count; ii++)
+    {
+      uint8_t reg = address + ii;
+      if(!is_shadowed(reg)) { continue; }
+      m_shadow[reg - SHADOW_FIRST] = data[ii];
+      // BOOT bit clears itself after reboot
+      if(LIS2DH12_CTRL_REG5 == reg) { m_shadow[reg - SHADOW_FIRST] &= ~LIS2DH12_BOOT_MASK; }
+      m_shadow_dirty &= ~(1UL << (reg - SHADOW_FIRST));
+    }
+}
+
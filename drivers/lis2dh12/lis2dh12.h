@@ -154,6 +154,12 @@ int lis2dh12_odr_to_hz(lis2dh12_sample_rate_t sample_rate);
  */
 lis2dh12_ret_t lis2dh12_set_fifo_mode(lis2dh12_fifo_mode_t mode);
 
+/**
+ *  Select INT pin, 1 or 2, whose interrupt signal triggers switch from stream to FIFO in Stream-to-FIFO mode.
+ *  Returns LIS2DH12_RET_INVALID if pin was not valid, error code from SPI write otherwise.
+ */
+lis2dh12_ret_t lis2dh12_set_fifo_trigger(uint8_t pin);
+
 /**
  *  Read specified number of samples into given buffer. values are read as
  *  buffer[index].x|y|z. Values are in mg, data type is int16_t. 
@@ -207,15 +213,25 @@ lis2dh12_ret_t lis2dh12_set_interrupt_configuration(uint8_t cfg, uint8_t functio
 lis2dh12_ret_t lis2dh12_set_threshold(uint8_t bits, uint8_t pin);
 
 /**
- *  Setup number of LSBs needed to trigger activity interrupt.
- *  Note: this targets only pin 2, and only if activity interrupt is enabled.
+ *  Setup number of LSBs needed to wake from sleep-to-wake low-power mode, ACT_THS.
+ *  Note: this is not the threshold of activity interrupt set with lis2dh12_set_activity_interrupt_pin_2.
  *
- *  @param bits number of LSBs required to trigger the interrupt
+ *  @param bits number of LSBs required to wake, up to 0x7F
  *
  *  @return error code from stack
  */
 lis2dh12_ret_t lis2dh12_set_activity_threshold(uint8_t bits);
 
+/**
+ *  Enable sleep-to-wake: LIS2DH12 drops to 10 Hz low-power mode after acceleration has been below threshold_mg
+ *  for duration_ms and returns to configured sample rate when threshold is exceeded. INT2 pin is high while sleeping.
+ *  Call after setting scale. Duration is counted in samples, lis2dh12_set_sample_rate recomputes it
+ *  for the new rate. threshold_mg 0 disables.
+ *
+ *  @return error code from SPI
+ */
+lis2dh12_ret_t lis2dh12_set_sleep_to_wake(uint16_t threshold_mg, uint32_t duration_ms);
+
 /**
  * Enable activity detection interrupt on pin 2. Interrupt is high for samples where high-passed acceleration exceeds mg
  */
@@ -223,11 +239,38 @@ lis2dh12_ret_t lis2dh12_set_activity_interrupt_pin_2(uint16_t mg);
 
 /**
  * Enable tap detection interrupt on given pin with click_cfg, threshold and time limit, window and latency.
+ * Other interrupts on the pin are kept. Times are counted at current sample rate, set sample rate first.
  */
 lis2dh12_ret_t lis2dh12_set_tap_interrupt(uint8_t click_cfg, int threshold_mg, int timelimit_ms, int latency_ms, int window_ms, uint8_t pin);
 
+/**
+ *  Defer configuration writes. After this call lis2dh12_set_* functions which modify CTRL_REG1..6, 
+ *  FIFO_CTRL_REG or INTx_CFG update only the driver copy of the registers and return immediately.
+ *  Scale and resolution used in sample conversion change as soon as the setter returns.
+ *
+ *  If the register copy has to be loaded from sensor and the read fails, writes are not deferred
+ *  and setters keep writing immediately.
+ *
+ *  @return error code from SPI read if register copy had to be loaded from sensor
+ */
+lis2dh12_ret_t lis2dh12_begin_config(void);
+
+/**
+ *  Write configuration changed since lis2dh12_begin_config and resume immediate writes.
+ *  Control registers are written in one auto-increment transaction.
+ *
+ *  Usage: lis2dh12_begin_config();
+ *         lis2dh12_set_sample_rate(LIS2DH12_RATE_10);
+ *         lis2dh12_set_resolution(LIS2DH12_RES12BIT);
+ *         lis2dh12_apply_config();
+ *
+ *  @return error code from SPI write
+ */
+lis2dh12_ret_t lis2dh12_apply_config(void);
+
 /**
  *  Internal functions for reading/writing registers. 
+ *  Writes to configuration registers keep driver copy of the registers up to date.
  */
 lis2dh12_ret_t lis2dh12_read_register(uint8_t address, uint8_t* const p_toRead, size_t count);
 lis2dh12_ret_t lis2dh12_write_register(uint8_t address, uint8_t* const dataToWrite, size_t count);
@@ -2,7 +2,7 @@
 #include "ruuvi_endpoints.h"
 #include "nrf_error.h"
 #include "lis2dh12.h"
-#include "math.h"
+#include "vector.h"
 
 #define NRF_LOG_MODULE_NAME "LIS2DH12_HANDLER"
 #include "nrf_log.h"
@@ -210,20 +210,37 @@ static ret_code_t set_target(uint8_t target)
 
   return ENDPOINT_SUCCESS;
 }
+/** Return true if any data target other than chain is set **/
+static bool has_targets(void)
+{
+  return m_state.p_ble_adv_handler || m_state.p_ble_gatt_handler || m_state.p_proprietary_handler ||
+         m_state.p_nfc_handler || m_state.p_ram_handler || m_state.p_flash_handler;
+}
+
 /** 
- *  Send transmission to all data endpoints.
- *  TODO: Can a function pointer / other code deduplication be used?
+ *  Send transmission to data endpoints other than chain.
  */
-static ret_code_t transmit(const ruuvi_standard_message_t message)
+static ret_code_t transmit_targets(const ruuvi_standard_message_t message)
 {
   ret_code_t err_code = ENDPOINT_SUCCESS;
-  NRF_LOG_DEBUG("Transmitting to all data points\r\n");  
   if(m_state.p_ble_adv_handler)     { err_code |= m_state.p_ble_adv_handler(message); }
   if(m_state.p_ble_gatt_handler)    { err_code |= m_state.p_ble_gatt_handler(message); }
   if(m_state.p_proprietary_handler) { err_code |= m_state.p_proprietary_handler(message); }
   if(m_state.p_nfc_handler)         { err_code |= m_state.p_nfc_handler(message); }
   if(m_state.p_ram_handler)         { err_code |= m_state.p_ram_handler(message); }
   if(m_state.p_flash_handler)       { err_code |= m_state.p_flash_handler(message); }
+  return err_code;
+}
+
+/** 
+ *  Send transmission to all data endpoints.
+ *  TODO: Can a function pointer / other code deduplication be used?
+ */
+static ret_code_t transmit(const ruuvi_standard_message_t message)
+{
+  ret_code_t err_code = ENDPOINT_SUCCESS;
+  NRF_LOG_DEBUG("Transmitting to all data points\r\n");  
+  err_code |= transmit_targets(message);
   if(m_state.p_chain_handler)
   { 
     ruuvi_standard_message_t chainmsg;
@@ -297,15 +314,15 @@ static ret_code_t read_sensor(const ruuvi_standard_message_t message)
   
     lis2dh12_sensor_buffer_t buffer; 
     err_code |= lis2dh12_read_samples(&buffer, 1);
-    uint16_t rvalue[4];
+    int16_t rvalue[4];
     rvalue[0] = buffer.sensor.x;
     rvalue[1] = buffer.sensor.y;
     rvalue[2] = buffer.sensor.z;
-    rvalue[3] = sqrt(rvalue[0]*rvalue[0] + rvalue[1]*rvalue[1] + rvalue[2]*rvalue[2]);
+    dsp_vector_magnitude_block(rvalue, 1, 4, &rvalue[3], 4);
     NRF_LOG_DEBUG("Sending raw reply\r\n");  
     ruuvi_standard_message_t reply = {.destination_endpoint = message.source_endpoint,
                                     .source_endpoint = ACCELERATION,
-                                    .type = UINT16,
+                                    .type = INT16,
                                     .payload = { 0 }};
     memcpy(reply.payload, rvalue, sizeof(reply.payload));
     err_code |= transmit(reply);
@@ -327,6 +344,7 @@ static ret_code_t configure_chain_downstream(const ruuvi_standard_message_t mess
   {
     m_state.downstream_endpoint = 0;
     m_state.p_chain_handler = NULL;
+    m_state.p_chain_block_handler = NULL;
   }
 
   //Else configure data chain
@@ -334,6 +352,7 @@ static ret_code_t configure_chain_downstream(const ruuvi_standard_message_t mess
   {  
     //Get chain handler
     m_state.p_chain_handler      = get_chain_handler();
+    m_state.p_chain_block_handler = get_chain_block_handler();
 
     //Get target endpoint
     m_state.downstream_endpoint  = message.source_endpoint;
@@ -403,12 +422,31 @@ ret_code_t lis2dh12_acceleration_handler(const ruuvi_standard_message_t message)
   return ENDPOINT_HANDLER_ERROR; // Should not be reached
 }
 
-/** Process sensor data, I.E. transmit data onwards **/
-static void process(const ruuvi_standard_message_t message)
+/** 
+ *  Process batch of samples, I.E. transmit data onwards.
+ *  Targets receive a message per sample, chain receives whole batch in one call if it supports blocks.
+ **/
+static void process(const int16_t samples[][4], const size_t count)
 {
-  if(TRANSMISSION_RATE_SAMPLERATE == m_state.configuration.transmission_rate)
+  if(TRANSMISSION_RATE_SAMPLERATE != m_state.configuration.transmission_rate) { return; }
+  bool targets = has_targets();
+  bool chain_block = (NULL != m_state.p_chain_block_handler);
+  if(targets || (m_state.p_chain_handler && !chain_block))
+  {
+    for(size_t ii = 0; ii < count; ii++)
+    {
+      ruuvi_standard_message_t reply = {.destination_endpoint = m_state.destination_endpoint,
+                                        .source_endpoint = ACCELERATION,
+                                        .type = INT16,
+                                        .payload = {0}};
+      memcpy(reply.payload, samples[ii], sizeof(reply.payload));
+      if(chain_block) { transmit_targets(reply); }
+      else            { transmit(reply); }
+    }
+  }
+  if(chain_block)
   {
-    transmit(message);
+    m_state.p_chain_block_handler(m_state.downstream_endpoint, samples[0], count);
   }
 }
 
@@ -421,25 +459,24 @@ void lis2dh12_scheduler_event_handler(void *p_event_data, uint16_t event_size)
     lis2dh12_sensor_buffer_t buffer[32];
     memset(buffer, 0, sizeof(buffer));
     lis2dh12_read_samples(buffer, count);
-    NRF_LOG_DEBUG("Sending raw UINT16 reply\r\n");
+    NRF_LOG_DEBUG("Sending raw INT16 reply\r\n");
+    // Samples as interleaved x, y, z, magnitude, same layout as INT16 payload
+    int16_t samples[32][4];
     for(int ii = 0; ii < count; ii++)
     {
-        int16_t rvalue[4];
-        rvalue[0] = buffer[ii].sensor.x;
-        rvalue[1] = buffer[ii].sensor.y;
-        rvalue[2] = buffer[ii].sensor.z;
-        rvalue[3] = sqrt(rvalue[0]*rvalue[0] + rvalue[1]*rvalue[1] + rvalue[2]*rvalue[2]);
-        ruuvi_standard_message_t reply = {.destination_endpoint = m_state.destination_endpoint,
-                                        .source_endpoint = ACCELERATION,
-                                        .type = INT16,
-                                        .payload = {0}};
-        memcpy(reply.payload, rvalue, sizeof(reply.payload));
-
-        // All samples are sent to processing.
-        process(reply);
-
-        NRF_LOG_DEBUG("%d %d %d %d\r\n", rvalue[0], rvalue[1], rvalue[2], rvalue[3]);
+        samples[ii][0] = buffer[ii].sensor.x;
+        samples[ii][1] = buffer[ii].sensor.y;
+        samples[ii][2] = buffer[ii].sensor.z;
     }
+    // Magnitude of whole batch, DSP_VECTOR
+    dsp_vector_magnitude_block(samples[0], count, 4, &samples[0][3], 4);
+    for(int ii = 0; ii < count; ii++)
+    {
+        NRF_LOG_DEBUG("%d %d %d %d\r\n", samples[ii][0], samples[ii][1], samples[ii][2], samples[ii][3]);
+    }
+
+    // All samples are sent to processing.
+    process(samples, count);
 }
 
 /** 
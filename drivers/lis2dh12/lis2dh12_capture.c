@@ -0,0 +1,135 @@
+#include "lis2dh12_capture.h"
+#include <string.h>
+#include "lis2dh12.h"
+#include "lis2dh12_registers.h"
+
+#define NRF_LOG_MODULE_NAME "LIS2DH12_CAPTURE"
+#include "nrf_log.h"
+#include "nrf_log_ctrl.h"
+
+static lis2dh12_capture_state_t m_state = LIS2DH12_CAPTURE_OFF;
+static lis2dh12_sample_rate_t   m_sample_rate = LIS2DH12_RATE_0;
+static lis2dh12_sensor_buffer_t m_samples[LIS2DH12_CAPTURE_SAMPLES]; // in mg
+static uint8_t  m_count = 0;          // Samples in record
+static uint8_t  m_pre_trigger = 0;    // Samples before trigger
+static uint16_t m_sequence = 0;       // Records completed since boot
+static uint32_t m_trigger_time = 0;
+static bool     m_complete = false;   // Record holds a complete event
+
+/** Number of samples in FIFO, FSS field reads 31 for full FIFO which is signaled by overrun **/
+static lis2dh12_ret_t fifo_available(size_t* count)
+{
+  uint8_t src = 0;
+  lis2dh12_ret_t err_code = lis2dh12_read_register(LIS2DH12_FIFO_SRC_REG, &src, 1);
+  if(src & LIS2DH12_OVRN_FIFO_MASK)  { *count = LIS2DH12_FIFO_MAX_LENGTH; }
+  else if(src & LIS2DH12_EMPTY_MASK) { *count = 0; }
+  else                               { *count = src & LIS2DH12_FSS_MASK; }
+  return err_code;
+}
+
+/** Append up to max samples from FIFO to record **/
+static lis2dh12_ret_t drain(size_t max)
+{
+  size_t count = 0;
+  lis2dh12_ret_t err_code = fifo_available(&count);
+  if(count > max) { count = max; }
+  if(LIS2DH12_RET_OK == err_code && count)
+  {
+    err_code |= lis2dh12_read_samples(&m_samples[m_count], count);
+    m_count += count;
+  }
+  return err_code;
+}
+
+/** Bypass resets FIFO contents and trigger **/
+static lis2dh12_ret_t restart_stream(void)
+{
+  lis2dh12_ret_t err_code = LIS2DH12_RET_OK;
+  err_code |= lis2dh12_set_fifo_mode(LIS2DH12_MODE_BYPASS);
+  err_code |= lis2dh12_set_fifo_mode(LIS2DH12_MODE_STREAM_TO_FIFO);
+  return err_code;
+}
+
+lis2dh12_ret_t lis2dh12_capture_arm(lis2dh12_sample_rate_t sample_rate, uint8_t trigger_pin)
+{
+  lis2dh12_ret_t err_code = LIS2DH12_RET_OK;
+  err_code |= lis2dh12_set_sample_rate(sample_rate);
+  err_code |= lis2dh12_set_fifo_trigger(trigger_pin);
+  err_code |= restart_stream();
+  m_sample_rate = sample_rate;
+  m_state = (LIS2DH12_RET_OK == err_code) ? LIS2DH12_CAPTURE_ARMED : LIS2DH12_CAPTURE_OFF;
+  return err_code;
+}
+
+lis2dh12_ret_t lis2dh12_capture_disarm(void)
+{
+  // Partial record is discarded
+  if(LIS2DH12_CAPTURE_TRIGGERED == m_state) { m_count = 0; }
+  m_state = LIS2DH12_CAPTURE_OFF;
+  return lis2dh12_set_fifo_mode(LIS2DH12_MODE_BYPASS);
+}
+
+lis2dh12_ret_t lis2dh12_capture_trigger(uint32_t time_ms)
+{
+  if(LIS2DH12_CAPTURE_ARMED != m_state) { return LIS2DH12_RET_OK; }
+  m_complete = false;
+  m_count = 0;
+  m_trigger_time = time_ms;
+  // FIFO is frozen to samples preceding the trigger, draining lets FIFO mode collect samples after it
+  lis2dh12_ret_t err_code = drain(LIS2DH12_FIFO_MAX_LENGTH);
+  m_pre_trigger = m_count;
+  m_state = LIS2DH12_CAPTURE_TRIGGERED;
+  NRF_LOG_DEBUG("Captured %d samples before trigger\r\n", m_pre_trigger);
+  return err_code;
+}
+
+lis2dh12_ret_t lis2dh12_capture_process(void)
+{
+  if(LIS2DH12_CAPTURE_TRIGGERED != m_state) { return LIS2DH12_RET_OK; }
+  size_t remaining = m_pre_trigger + LIS2DH12_FIFO_MAX_LENGTH - m_count;
+  lis2dh12_ret_t err_code = drain(remaining);
+  // FIFO stops at 32 samples after drain, record is complete once those have been read
+  if(m_count == m_pre_trigger + LIS2DH12_FIFO_MAX_LENGTH || LIS2DH12_RET_OK != err_code)
+  {
+    m_complete = (LIS2DH12_RET_OK == err_code);
+    if(m_complete) { m_sequence++; }
+    err_code |= restart_stream();
+    m_state = (LIS2DH12_RET_OK == err_code) ? LIS2DH12_CAPTURE_ARMED : LIS2DH12_CAPTURE_OFF;
+    NRF_LOG_DEBUG("Captured %d samples\r\n", m_count);
+  }
+  return err_code;
+}
+
+lis2dh12_capture_state_t lis2dh12_capture_state(void)
+{
+  return m_state;
+}
+
+size_t lis2dh12_capture_serialize(uint8_t* buffer, size_t length)
+{
+  if(NULL == buffer || LIS2DH12_CAPTURE_SERIALIZED_LENGTH > length || !m_complete) { return 0; }
+  uint16_t rate = lis2dh12_odr_to_hz(m_sample_rate);
+  uint8_t* p = buffer;
+  *p++ = LIS2DH12_CAPTURE_FORMAT_VERSION;
+  *p++ = m_count;
+  *p++ = m_pre_trigger;
+  *p++ = rate;
+  *p++ = rate >> 8;
+  *p++ = m_sequence;
+  *p++ = m_sequence >> 8;
+  *p++ = m_trigger_time;
+  *p++ = m_trigger_time >> 8;
+  *p++ = m_trigger_time >> 16;
+  *p++ = m_trigger_time >> 24;
+  for(size_t ii = 0; ii < m_count; ii++)
+  {
+    const acceleration_t* sample = &m_samples[ii].sensor;
+    *p++ = sample->x;
+    *p++ = sample->x >> 8;
+    *p++ = sample->y;
+    *p++ = sample->y >> 8;
+    *p++ = sample->z;
+    *p++ = sample->z >> 8;
+  }
+  return p - buffer;
+}
@@ -0,0 +1,100 @@
+#ifndef LIS2DH12_CAPTURE_H
+#define LIS2DH12_CAPTURE_H
+
+/**
+ *  Pre-trigger capture of acceleration events.
+ *
+ *  LIS2DH12 is kept in Stream-to-FIFO mode with the activity interrupt pin as the trigger.
+ *  The FIFO holds the latest 32 samples until the activity interrupt switches it to
+ *  FIFO mode, which freezes the samples preceding the event. The application calls
+ *  lis2dh12_capture_trigger from the pin handler to drain them into the event
+ *  record, after which the FIFO collects the samples following the event.
+ *  lis2dh12_capture_process, called periodically, drains those and re-arms the FIFO.
+ *  The MCU wakes twice per event rather than once per sample.
+ *
+ *  Samples that arrive while the handler is on its way to drain the frozen FIFO are
+ *  lost, so there is a gap of at most the pin interrupt latency between the halves.
+ *
+ *  The activity interrupt must be configured by the application, e.g. with
+ *  lis2dh12_set_activity_interrupt_pin_2, and routed to the trigger pin given to
+ *  lis2dh12_capture_arm. Capture owns the FIFO: while capture is busy,
+ *  reading samples would pop the event record. While armed, reading one sample pops the
+ *  oldest sample, which the stream replaces within one sample period.
+ *
+ *  There is one record buffer. The latest complete record can be read with
+ *  lis2dh12_capture_serialize until the next event triggers.
+ */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "lis2dh12.h"
+
+/** Samples in record, up to a full FIFO before and after the trigger **/
+#define LIS2DH12_CAPTURE_SAMPLES        (2 * LIS2DH12_FIFO_MAX_LENGTH)
+
+#define LIS2DH12_CAPTURE_FORMAT_VERSION 1
+#define LIS2DH12_CAPTURE_HEADER_LENGTH  11
+#define LIS2DH12_CAPTURE_SAMPLE_LENGTH  6
+
+/** Serialized record length, fits a BLE bulk transfer **/
+#define LIS2DH12_CAPTURE_SERIALIZED_LENGTH (LIS2DH12_CAPTURE_HEADER_LENGTH + \
+                                            LIS2DH12_CAPTURE_SAMPLES * LIS2DH12_CAPTURE_SAMPLE_LENGTH)
+
+typedef enum
+{
+  LIS2DH12_CAPTURE_OFF = 0,   /**< FIFO not used by capture */
+  LIS2DH12_CAPTURE_ARMED,     /**< Stream-to-FIFO, waiting for trigger */
+  LIS2DH12_CAPTURE_TRIGGERED  /**< Collecting samples after trigger */
+}lis2dh12_capture_state_t;
+
+/**
+ *  Start capture at given sample rate. Clears FIFO and sets Stream-to-FIFO mode triggered by interrupt on trigger_pin.
+ *  Record sample rate is taken as constant, do not combine with lis2dh12_set_sleep_to_wake.
+ *
+ *  @param trigger_pin 1 or 2, INT pin the activity interrupt is routed to
+ *  @return error code from SPI write
+ */
+lis2dh12_ret_t lis2dh12_capture_arm(lis2dh12_sample_rate_t sample_rate, uint8_t trigger_pin);
+
+/**
+ *  Stop capture, set FIFO to bypass. Sample rate is not changed. Latest record is kept.
+ *
+ *  @return error code from SPI write
+ */
+lis2dh12_ret_t lis2dh12_capture_disarm(void);
+
+/**
+ *  Drain samples preceding the event. Call from trigger pin handler in main context.
+ *  Does nothing unless capture is armed, so repeated interrupts during an event are ignored.
+ *
+ *  @param time_ms timestamp of the event, stored in record
+ *  @return error code from SPI
+ */
+lis2dh12_ret_t lis2dh12_capture_trigger(uint32_t time_ms);
+
+/**
+ *  Drain samples following the event, complete record and re-arm once record is full.
+ *  Call periodically, e.g. from main sensor task. Does nothing unless capture is triggered.
+ *
+ *  @return error code from SPI
+ */
+lis2dh12_ret_t lis2dh12_capture_process(void);
+
+/**
+ *  Return capture state. Do not read samples from LIS2DH12 while state is LIS2DH12_CAPTURE_TRIGGERED.
+ */
+lis2dh12_capture_state_t lis2dh12_capture_state(void);
+
+/**
+ *  Serializes latest complete record for BLE transfer. Little endian:
+ *  version (u8), number of samples (u8), samples before trigger (u8), sample rate in Hz (u16),
+ *  record sequence number (u16), trigger time in ms (u32),
+ *  and samples from oldest to newest as x, y, z (i16) in mg.
+ *
+ *  Returns number of bytes written, 0 if there is no complete record or buffer
+ *  is shorter than LIS2DH12_CAPTURE_SERIALIZED_LENGTH.
+ */
+size_t lis2dh12_capture_serialize(uint8_t* buffer, size_t length);
+
+#endif
@@ -0,0 +1,58 @@
+#include "lis2dh12_orientation.h"
+#include "vector.h"
+
+#define FRACTION_BITS 4  // Filter state resolution is 1/16 mg
+
+static int32_t m_gravity[3];          // mg, FRACTION_BITS fixed point
+static int16_t m_reference[3];        // mg
+static bool    m_gravity_valid = false;
+static bool    m_reference_valid = false;
+
+/** Filtered gravity in mg **/
+static void gravity_get(int16_t gravity[3])
+{
+  for(uint8_t ii = 0; ii < 3; ii++)
+  {
+    gravity[ii] = (m_gravity[ii] + (1 << (FRACTION_BITS - 1))) >> FRACTION_BITS;
+  }
+}
+
+void lis2dh12_orientation_update(const acceleration_t* const sample, uint8_t shift)
+{
+  // Multiply, left shift of negative value is undefined
+  const int32_t input[3] = { (int32_t)sample->x * (1 << FRACTION_BITS),
+                             (int32_t)sample->y * (1 << FRACTION_BITS),
+                             (int32_t)sample->z * (1 << FRACTION_BITS) };
+  for(uint8_t ii = 0; ii < 3; ii++)
+  {
+    if(m_gravity_valid) { m_gravity[ii] += (input[ii] - m_gravity[ii]) >> shift; }
+    else                { m_gravity[ii] = input[ii]; }
+  }
+  m_gravity_valid = true;
+}
+
+void lis2dh12_orientation_set_reference(void)
+{
+  if(!m_gravity_valid) { return; }
+  gravity_get(m_reference);
+  m_reference_valid = true;
+}
+
+bool lis2dh12_orientation_has_reference(void)
+{
+  return m_reference_valid;
+}
+
+void lis2dh12_orientation_reset(void)
+{
+  m_gravity_valid = false;
+  m_reference_valid = false;
+}
+
+int16_t lis2dh12_orientation_angle(void)
+{
+  if(!m_gravity_valid || !m_reference_valid) { return LIS2DH12_ORIENTATION_INVALID; }
+  int16_t gravity[3];
+  gravity_get(gravity);
+  return dsp_vector_angle(m_reference, gravity);
+}
@@ -0,0 +1,51 @@
+#ifndef LIS2DH12_ORIENTATION_H
+#define LIS2DH12_ORIENTATION_H
+
+/**
+ *  Opening angle of a hinged door or hatch from the direction of gravity.
+ *
+ *  Samples are low pass filtered to the gravity vector. The angle is the angle between
+ *  gravity and a reference taken while the door is closed, so mounting orientation does not
+ *  matter. Rotation about a vertical hinge does not change gravity, so ordinary doors read
+ *  0 degrees throughout and only hatches, lids and tilting windows report an angle.
+ *
+ *  The engine does no SPI transactions of its own, the application feeds the samples it
+ *  reads anyway. Angle is calculated with integer atan2 only when requested.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "lis2dh12.h"
+
+/** Angle is unknown until reference and gravity are available **/
+#define LIS2DH12_ORIENTATION_INVALID -1
+
+/**
+ *  Low pass filter sample into gravity, y += (x - y) / 2^shift. First sample initializes the filter.
+ *
+ *  @param sample acceleration in mg
+ *  @param shift filter strength, 0 uses the sample as is
+ */
+void lis2dh12_orientation_update(const acceleration_t* const sample, uint8_t shift);
+
+/**
+ *  Store current gravity as the closed position. Does nothing until first sample.
+ */
+void lis2dh12_orientation_set_reference(void);
+
+/**
+ *  True if reference has been stored.
+ */
+bool lis2dh12_orientation_has_reference(void);
+
+/**
+ *  Forget gravity and reference, e.g. after the tag has been moved.
+ */
+void lis2dh12_orientation_reset(void);
+
+/**
+ *  Return opening angle in 0.1 degrees, 0 ... 1800, or LIS2DH12_ORIENTATION_INVALID.
+ */
+int16_t lis2dh12_orientation_angle(void);
+
+#endif
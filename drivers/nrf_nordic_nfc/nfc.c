@@ -123,7 +123,7 @@ void data_record_add(nfc_ndef_msg_desc_t* nfc_msg, uint8_t* data, uint32_t data_
   static char data_string[256] = { 0 };
   memcpy(data_string, prefix, sizeof(prefix));
   for (uint8_t ii = 0; ii < data_length; ii++){
-    sprintf(data_string+2*ii, "%02x", data[ii]);
+    sprintf(data_string + sizeof(prefix) + 2*ii, "%02x", data[ii]);
   }
   uint8_t* data_bytes = (void*)&data_string;
   static const uint8_t data_code[] = {'d', 't'};
@@ -9,6 +9,8 @@
 #include "boards.h"
 
 #include "ruuvi_endpoints.h"
+#include "ringbuffer.h"
+#include "trace.h"
 
 #define NRF_LOG_MODULE_NAME "PIN_INTERRUPT"
 #include "nrf_log.h"
@@ -27,14 +29,41 @@ ret_code_t pin_interrupt_init()
 
 //Look-up table for event handlers
 static message_handler pin_event_handlers[32] = {0};
+
+/** Pin edge captured in interrupt, handled in main context by pin_interrupt_process **/
+typedef struct{
+  uint8_t pin;
+  uint8_t level;
+}pin_event_t;
+
+// Room for bursts of a bouncing reed switch or button between two main loop rounds
+RINGBUFFER_SPSC_DEF(pin_events, pin_event_t, PIN_INTERRUPT_QUEUE_LENGTH);
+static volatile uint32_t pin_events_dropped = 0;
+
 static void in_pin_handler(nrf_drv_gpiote_pin_t pin, nrf_gpiote_polarity_t action)
 {
-  //Call event handler with empty message TODO: invalid message add context?
-  NRF_LOG_DEBUG("Handling pin event\r\n");
-  ruuvi_standard_message_t message;
-  message.payload[0] = pin;
-  message.payload[1] = nrf_gpio_pin_read(pin);
-  if (NULL != pin_event_handlers[pin]) { (pin_event_handlers[pin])(message);}
+  pin_event_t event = { .pin = pin, .level = nrf_gpio_pin_read(pin) };
+  TRACE_EVENT(TRACE_PIN, pin | (event.level << 8));
+  if(!ringbuffer_spsc_push(&pin_events, &event)) { pin_events_dropped++; }
+}
+
+void pin_interrupt_process(void)
+{
+  pin_event_t event;
+  while(ringbuffer_spsc_pop(&pin_events, &event))
+  {
+    //Call event handler with empty message TODO: invalid message add context?
+    NRF_LOG_DEBUG("Handling pin event\r\n");
+    ruuvi_standard_message_t message;
+    message.payload[0] = event.pin;
+    message.payload[1] = event.level;
+    if (NULL != pin_event_handlers[event.pin]) { (pin_event_handlers[event.pin])(message);}
+  }
+  if(pin_events_dropped)
+  {
+    NRF_LOG_WARNING("%d pin events dropped\r\n", pin_events_dropped);
+    pin_events_dropped = 0;
+  }
 }
 /**
  *  Enable interrput on pin. Pull-up is enabled on HITOLOW, pull-down is enabled on LOWTIHI
@@ -43,7 +72,7 @@ static void in_pin_handler(nrf_drv_gpiote_pin_t pin, nrf_gpiote_polarity_t actio
  *  NRF_GPIOTE_POLARITY_HITOLO
  *  NRF_GPIOTE_POLARITY_TOGGLE
  *
- *  Message handler is called with an empty message on event.
+ *  Message handler is called with an empty message on event from pin_interrupt_process.
  */
 ret_code_t pin_interrupt_enable(nrf_drv_gpiote_pin_t pin, nrf_gpiote_polarity_t polarity, nrf_gpio_pin_pull_t pull, message_handler handler)
 {
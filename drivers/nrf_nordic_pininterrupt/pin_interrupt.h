@@ -6,7 +6,18 @@
 #include "nrf_error.h"
 #include "ruuvi_endpoints.h"
 
+// Pin events buffered between interrupt and pin_interrupt_process, power of two
+#ifndef PIN_INTERRUPT_QUEUE_LENGTH
+  #define PIN_INTERRUPT_QUEUE_LENGTH 32
+#endif
+
 ret_code_t pin_interrupt_init();
 ret_code_t pin_interrupt_enable(nrf_drv_gpiote_pin_t pin, nrf_gpiote_polarity_t polarity, nrf_gpio_pin_pull_t pull, message_handler handler);
 
+/**
+ *  Calls message handlers of pin events captured since last call, oldest first.
+ *  Interrupt only queues the pin and its level, call this from main loop.
+ */
+void pin_interrupt_process(void);
+
 #endif
\ No newline at end of file
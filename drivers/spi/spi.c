@@ -22,6 +22,7 @@ For a detailed description see the detailed description in @ref spi.h
 #include "nrf_delay.h"
 #include "app_util_platform.h"
 #include "boards.h"
+#include "trace.h"
 
 #define NRF_LOG_MODULE_NAME "SPI"
 #include "nrf_log.h"
@@ -37,6 +38,7 @@ For a detailed description see the detailed description in @ref spi.h
 /* PROTOTYPES *************************************************************************************/
 
 void spi_event_handler(nrf_drv_spi_evt_t const * p_event);
+static void transfer_wait(uint8_t* const p_tx, uint8_t tx_count, uint8_t* const p_rx, uint8_t rx_count);
 
 /* VARIABLES **************************************************************************************/
 static const nrf_drv_spi_t spi = NRF_DRV_SPI_INSTANCE(SPI_INSTANCE);  /**< SPI instance. */
@@ -95,6 +97,7 @@ extern SPI_Ret spi_transfer_bme280(uint8_t* const p_toWrite, uint8_t count, uint
         spi_xfer_done = false;
 
         nrf_gpio_pin_clear(SPIM0_SS_HUMI_PIN);
+        TRACE_EVENT(TRACE_SPI_START, (SPIM0_SS_HUMI_PIN << 8) | count);
         APP_ERROR_CHECK(nrf_drv_spi_transfer(&spi, p_toWrite, count, p_toRead, count));
         //Locks if run in interrupt context
         while (!spi_xfer_done)
@@ -104,6 +107,7 @@ extern SPI_Ret spi_transfer_bme280(uint8_t* const p_toWrite, uint8_t count, uint
             NRF_LOG_DEBUG("SPI status %d\r\n", err_code);
         }
         nrf_gpio_pin_set(SPIM0_SS_HUMI_PIN);
+        TRACE_EVENT(TRACE_SPI_STOP, (SPIM0_SS_HUMI_PIN << 8) | count);
         retVal = SPI_RET_OK;
 	}
 	else
@@ -117,7 +121,7 @@ extern SPI_Ret spi_transfer_bme280(uint8_t* const p_toWrite, uint8_t count, uint
 extern SPI_Ret spi_transfer_lis2dh12(uint8_t* const p_toWrite, uint8_t count, uint8_t* const p_toRead)
 {
     SPI_Ret retVal = SPI_RET_OK;
-    if ((NULL == p_toWrite) || (NULL == p_toRead))
+    if (NULL == p_toWrite)
     {
         retVal = SPI_RET_ERROR;
     }
@@ -125,17 +129,39 @@ extern SPI_Ret spi_transfer_lis2dh12(uint8_t* const p_toWrite, uint8_t count, ui
     /* check if an other SPI transfer is running */
     if ((true == spi_xfer_done) && (SPI_RET_OK == retVal))
     {
-        spi_xfer_done = false;
+        nrf_gpio_pin_clear(SPIM0_SS_ACC_PIN);
+        TRACE_EVENT(TRACE_SPI_START, (SPIM0_SS_ACC_PIN << 8) | count);
+        transfer_wait(p_toWrite, count, p_toRead, (NULL == p_toRead) ? 0 : count);
+        nrf_gpio_pin_set(SPIM0_SS_ACC_PIN);
+        TRACE_EVENT(TRACE_SPI_STOP, (SPIM0_SS_ACC_PIN << 8) | count);
+        retVal = SPI_RET_OK;
+    }
+    else
+    {
+        retVal = SPI_RET_BUSY;
+    }
+
+    return retVal;
+}
 
+extern SPI_Ret spi_read_lis2dh12(uint8_t* const p_command, uint8_t count, uint8_t* const p_toRead)
+{
+    SPI_Ret retVal = SPI_RET_OK;
+    if ((NULL == p_command) || (NULL == p_toRead))
+    {
+        retVal = SPI_RET_ERROR;
+    }
+
+    /* check if an other SPI transfer is running */
+    if ((true == spi_xfer_done) && (SPI_RET_OK == retVal))
+    {
         nrf_gpio_pin_clear(SPIM0_SS_ACC_PIN);
-        nrf_drv_spi_transfer(&spi, p_toWrite, count, p_toRead, count);
-        while (!spi_xfer_done)
-        {
-            //Requires initialized softdevice - TODO
-            sd_app_evt_wait();
-            //__WFE(); 
-        }
+        TRACE_EVENT(TRACE_SPI_START, (SPIM0_SS_ACC_PIN << 8) | (uint8_t)(count + 1));
+        /* Chip select stays active between command and data */
+        transfer_wait(p_command, 1, NULL, 0);
+        transfer_wait(NULL, 0, p_toRead, count);
         nrf_gpio_pin_set(SPIM0_SS_ACC_PIN);
+        TRACE_EVENT(TRACE_SPI_STOP, (SPIM0_SS_ACC_PIN << 8) | (uint8_t)(count + 1));
         retVal = SPI_RET_OK;
     }
     else
@@ -149,6 +175,22 @@ extern SPI_Ret spi_transfer_lis2dh12(uint8_t* const p_toWrite, uint8_t count, ui
 
 /* INTERNAL FUNCTIONS *****************************************************************************/
 
+/**
+ * Start transfer and wait for it to complete, chip select is handled by caller.
+ * Either direction may have zero length, SPIM sends over-read character when there is nothing to send.
+ */
+static void transfer_wait(uint8_t* const p_tx, uint8_t tx_count, uint8_t* const p_rx, uint8_t rx_count)
+{
+    spi_xfer_done = false;
+    nrf_drv_spi_transfer(&spi, p_tx, tx_count, p_rx, rx_count);
+    while (!spi_xfer_done)
+    {
+        //Requires initialized softdevice - TODO
+        sd_app_evt_wait();
+        //__WFE(); 
+    }
+}
+
 
 /**
  * SPI user event handler
@@ -69,7 +69,7 @@ extern SPI_Ret spi_transfer_bme280(uint8_t* const p_toWrite, uint8_t count, uint
  * Send and receive bytes for lis2dh12 Acceleration Sensor
  *
  * @param[in] p_toWrite Data to transfer
- * @param[out] p_toRead Receive buffer
+ * @param[out] p_toRead Receive buffer, NULL to only write
  * @param[in] count Size of p_toRead and p_toWrite
  *
  * @return SPI_RET_OK SPI transfer was successful
@@ -77,6 +77,22 @@ extern SPI_Ret spi_transfer_bme280(uint8_t* const p_toWrite, uint8_t count, uint
  */
 extern SPI_Ret spi_transfer_lis2dh12(uint8_t* const p_toWrite, uint8_t count, uint8_t* const p_toRead);
 
+/**
+ * Send command byte and read bytes after it for lis2dh12 Acceleration Sensor
+ *
+ * Command and data are separate DMA transfers under one chip select, so data is
+ * received directly to p_toRead without room for the response to the command byte.
+ * Buffers must be in RAM.
+ *
+ * @param[in] p_command Command byte, i.e. address with read bit
+ * @param[out] p_toRead Receive buffer
+ * @param[in] count Size of p_toRead
+ *
+ * @return SPI_RET_OK SPI transfer was successful
+ * @return SPI_RET_BUSY SPI is busy with other transfer, please try again
+ */
+extern SPI_Ret spi_read_lis2dh12(uint8_t* const p_command, uint8_t count, uint8_t* const p_toRead);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,58 @@
+/**
+ *  Minimal benchmark harness for the host build.
+ *
+ *  Each benchmark is a function taking a bench_t. It must run its operation
+ *  b->n times. The runner grows n until the run lasts long enough to be measured
+ *  and reports time, bytes allocated and allocations per operation.
+ *
+ *  Setup which should not be measured can be excluded with bench_timer_stop()
+ *  and bench_timer_start(). Allocations are counted only while the timer runs.
+ */
+#ifndef BENCH_H
+#define BENCH_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+typedef struct
+{
+  uint64_t n;            /**< Number of operations to run */
+} bench_t;
+
+typedef void (*bench_function_t)(bench_t* b);
+
+typedef struct
+{
+  const char*      name;
+  bench_function_t function;
+} bench_case_t;
+
+/** Terminates a bench_case_t table */
+#define BENCH_CASES_END { NULL, NULL }
+
+void bench_timer_start(void);
+void bench_timer_stop(void);
+
+/** Prevents compiler from optimizing away the computation of value pointed by p */
+static inline void bench_keep(const void* p)
+{
+  __asm__ volatile("" : : "g"(p) : "memory");
+}
+
+/** Allocation accounting, implemented in bench_alloc.c */
+void     bench_alloc_enable(bool enable);
+void     bench_alloc_reset(void);
+uint64_t bench_alloc_bytes(void);
+uint64_t bench_alloc_count(void);
+
+/** Benchmark tables of each library */
+extern const bench_case_t bench_ringbuffer_cases[];
+extern const bench_case_t bench_dsp_cases[];
+extern const bench_case_t bench_sensortag_cases[];
+extern const bench_case_t bench_base64_cases[];
+extern const bench_case_t bench_base91_cases[];
+extern const bench_case_t bench_endpoints_cases[];
+extern const bench_case_t bench_drivers_cases[];
+
+#endif
@@ -0,0 +1,68 @@
+/**
+ *  Counting wrappers for heap functions. Linked with -Wl,--wrap=malloc etc.
+ *  so every allocation made by the code under test passes through here.
+ */
+#include <stdlib.h>
+#include "bench.h"
+
+void* __real_malloc(size_t size);
+void* __real_calloc(size_t nmemb, size_t size);
+void* __real_realloc(void* ptr, size_t size);
+void  __real_free(void* ptr);
+
+static bool     m_enabled = false;
+static uint64_t m_bytes = 0;
+static uint64_t m_count = 0;
+
+static inline void account(size_t size)
+{
+  if(m_enabled)
+  {
+    m_bytes += size;
+    m_count++;
+  }
+}
+
+void* __wrap_malloc(size_t size)
+{
+  account(size);
+  return __real_malloc(size);
+}
+
+void* __wrap_calloc(size_t nmemb, size_t size)
+{
+  account(nmemb * size);
+  return __real_calloc(nmemb, size);
+}
+
+void* __wrap_realloc(void* ptr, size_t size)
+{
+  account(size);
+  return __real_realloc(ptr, size);
+}
+
+void __wrap_free(void* ptr)
+{
+  __real_free(ptr);
+}
+
+void bench_alloc_enable(bool enable)
+{
+  m_enabled = enable;
+}
+
+void bench_alloc_reset(void)
+{
+  m_bytes = 0;
+  m_count = 0;
+}
+
+uint64_t bench_alloc_bytes(void)
+{
+  return m_bytes;
+}
+
+uint64_t bench_alloc_count(void)
+{
+  return m_count;
+}
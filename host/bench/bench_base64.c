@@ -0,0 +1,20 @@
+#include "bench.h"
+#include "base64.h"
+
+static void bench_encode(bench_t* b)
+{
+  const uint8_t data[24] = { 0x05, 0x12, 0xFC, 0x53, 0x94, 0xC3, 0x7C, 0x00,
+                             0x04, 0xFF, 0xFC, 0x04, 0x0C, 0xAC, 0x36, 0x42,
+                             0x00, 0xCD, 0xCB, 0xB8, 0x33, 0x4C, 0x88, 0x4F };
+  char result[40];
+  for(uint64_t ii = 0; ii < b->n; ii++)
+  {
+    base64encode(data, sizeof(data), result, sizeof(result));
+    bench_keep(result);
+  }
+}
+
+const bench_case_t bench_base64_cases[] = {
+  { "base64encode/24B",                  bench_encode },
+  BENCH_CASES_END
+};
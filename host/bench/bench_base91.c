@@ -0,0 +1,44 @@
+#include "bench.h"
+#include "base91.h"
+
+static const uint8_t m_data[24] = { 0x05, 0x12, 0xFC, 0x53, 0x94, 0xC3, 0x7C, 0x00,
+                                    0x04, 0xFF, 0xFC, 0x04, 0x0C, 0xAC, 0x36, 0x42,
+                                    0x00, 0xCD, 0xCB, 0xB8, 0x33, 0x4C, 0x88, 0x4F };
+
+static void bench_encode(bench_t* b)
+{
+  struct basE91 state;
+  char encoded[40];
+  for(uint64_t ii = 0; ii < b->n; ii++)
+  {
+    basE91_init(&state);
+    size_t length = basE91_encode(&state, m_data, sizeof(m_data), encoded);
+    length += basE91_encode_end(&state, encoded + length);
+    bench_keep(encoded);
+  }
+}
+
+static void bench_decode(bench_t* b)
+{
+  bench_timer_stop();
+  struct basE91 state;
+  char encoded[40];
+  uint8_t decoded[sizeof(m_data)];
+  basE91_init(&state);
+  size_t encoded_length = basE91_encode(&state, m_data, sizeof(m_data), encoded);
+  encoded_length += basE91_encode_end(&state, encoded + encoded_length);
+  bench_timer_start();
+  for(uint64_t ii = 0; ii < b->n; ii++)
+  {
+    basE91_init(&state);
+    size_t length = basE91_decode(&state, encoded, encoded_length, decoded);
+    length += basE91_decode_end(&state, decoded + length);
+    bench_keep(decoded);
+  }
+}
+
+const bench_case_t bench_base91_cases[] = {
+  { "basE91_encode+end/24B",             bench_encode },
+  { "basE91_decode+end/24B",             bench_decode },
+  BENCH_CASES_END
+};
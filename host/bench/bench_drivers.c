@@ -0,0 +1,149 @@
+#include "bench.h"
+#include "bme280.h"
+#include "lis2dh12.h"
+#include "host_clock.h"
+#include "spi_host.h"
+
+/**
+ * Times include the device models in devices/, compare drivers against each
+ * other rather than against target cycle counts.
+ */
+static void setup_lis2dh12(lis2dh12_sample_rate_t rate)
+{
+  host_clock_reset();
+  spi_host_reset();
+  lis2dh12_init();
+  lis2dh12_enable();
+  lis2dh12_set_scale(LIS2DH12_SCALE2G);
+  lis2dh12_set_resolution(LIS2DH12_RES10BIT);
+  lis2dh12_set_sample_rate(rate);
+}
+
+static void setup_bme280(void)
+{
+  host_clock_reset();
+  spi_host_reset();
+  bme280_init();
+  bme280_set_oversampling_hum(BME280_OVERSAMPLING_1);
+  bme280_set_oversampling_temp(BME280_OVERSAMPLING_1);
+  bme280_set_oversampling_press(BME280_OVERSAMPLING_1);
+  bme280_set_mode(BME280_MODE_NORMAL);
+  host_clock_advance_us(10000);
+}
+
+static void bench_lis2dh12_read_1(bench_t* b)
+{
+  lis2dh12_sensor_buffer_t buffer;
+  bench_timer_stop();
+  setup_lis2dh12(LIS2DH12_RATE_1);
+  bench_timer_start();
+  for(uint64_t ii = 0; ii < b->n; ii++)
+  {
+    lis2dh12_read_samples(&buffer, 1);
+    bench_keep(&buffer);
+  }
+}
+
+static void bench_lis2dh12_read_fifo(bench_t* b)
+{
+  lis2dh12_sensor_buffer_t buffer[LIS2DH12_FIFO_MAX_LENGTH];
+  bench_timer_stop();
+  setup_lis2dh12(LIS2DH12_RATE_400);
+  lis2dh12_set_fifo_mode(LIS2DH12_MODE_STREAM);
+  bench_timer_start();
+  for(uint64_t ii = 0; ii < b->n; ii++)
+  {
+    // 32 samples at 400 Hz
+    host_clock_advance_us(80000);
+    lis2dh12_read_samples(buffer, LIS2DH12_FIFO_MAX_LENGTH);
+    bench_keep(buffer);
+  }
+}
+
+static void bench_lis2dh12_set_sample_rate(bench_t* b)
+{
+  bench_timer_stop();
+  setup_lis2dh12(LIS2DH12_RATE_1);
+  bench_timer_start();
+  for(uint64_t ii = 0; ii < b->n; ii++)
+  {
+    lis2dh12_set_sample_rate((ii & 1) ? LIS2DH12_RATE_10 : LIS2DH12_RATE_1);
+  }
+}
+
+// Switch rate and resolution, e.g. between RAWv1 and RAWv2 configurations
+static void bench_lis2dh12_apply_config(bench_t* b)
+{
+  bench_timer_stop();
+  setup_lis2dh12(LIS2DH12_RATE_1);
+  bench_timer_start();
+  for(uint64_t ii = 0; ii < b->n; ii++)
+  {
+    lis2dh12_begin_config();
+    lis2dh12_set_sample_rate((ii & 1) ? LIS2DH12_RATE_10 : LIS2DH12_RATE_1);
+    lis2dh12_set_resolution((ii & 1) ? LIS2DH12_RES12BIT : LIS2DH12_RES10BIT);
+    lis2dh12_apply_config();
+  }
+}
+
+static void bench_lis2dh12_reset(bench_t* b)
+{
+  bench_timer_stop();
+  setup_lis2dh12(LIS2DH12_RATE_1);
+  bench_timer_start();
+  for(uint64_t ii = 0; ii < b->n; ii++)
+  {
+    lis2dh12_reset();
+  }
+}
+
+static void bench_bme280_read(bench_t* b)
+{
+  bench_timer_stop();
+  setup_bme280();
+  bench_timer_start();
+  for(uint64_t ii = 0; ii < b->n; ii++)
+  {
+    bme280_read_measurements();
+  }
+}
+
+static void bench_bme280_compensate(bench_t* b)
+{
+  bme280_data_t data;
+  bench_timer_stop();
+  setup_bme280();
+  bme280_read_measurements();
+  bench_timer_start();
+  for(uint64_t ii = 0; ii < b->n; ii++)
+  {
+    data.temperature = bme280_get_temperature();
+    data.pressure    = bme280_get_pressure();
+    data.humidity    = bme280_get_humidity();
+    bench_keep(&data);
+  }
+}
+
+static void bench_bme280_is_measuring(bench_t* b)
+{
+  bench_timer_stop();
+  setup_bme280();
+  bench_timer_start();
+  for(uint64_t ii = 0; ii < b->n; ii++)
+  {
+    volatile int measuring = bme280_is_measuring();
+    (void)measuring;
+  }
+}
+
+const bench_case_t bench_drivers_cases[] = {
+  { "lis2dh12_read_samples/1",           bench_lis2dh12_read_1 },
+  { "lis2dh12_read_samples/32",          bench_lis2dh12_read_fifo },
+  { "lis2dh12_set_sample_rate",          bench_lis2dh12_set_sample_rate },
+  { "lis2dh12_apply_config",             bench_lis2dh12_apply_config },
+  { "lis2dh12_reset",                    bench_lis2dh12_reset },
+  { "bme280_read_measurements",          bench_bme280_read },
+  { "bme280_get_temperature+pressure+humidity", bench_bme280_compensate },
+  { "bme280_is_measuring",               bench_bme280_is_measuring },
+  BENCH_CASES_END
+};
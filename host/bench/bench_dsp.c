@@ -0,0 +1,224 @@
+#include "bench.h"
+#include "dsp.h"
+#include "stdev.h"
+#include "fir.h"
+#include "biquad.h"
+#include "vector.h"
+#include "goertzel.h"
+#include "fft.h"
+#include "ruuvi_endpoints.h"
+
+#define STDEV_WINDOW 32
+
+static void bench_init_uninit(bench_t* b)
+{
+  for(uint64_t ii = 0; ii < b->n; ii++)
+  {
+    dsp_filter_t filter = dsp_init(DSP_STDEV, STDEV_WINDOW);
+    bench_keep(&filter);
+    dsp_uninit(&filter);
+  }
+}
+
+static void bench_is_init(bench_t* b)
+{
+  bench_timer_stop();
+  dsp_filter_t filter = dsp_init(DSP_STDEV, STDEV_WINDOW);
+  bench_timer_start();
+  for(uint64_t ii = 0; ii < b->n; ii++)
+  {
+    volatile int status = dsp_is_init(&filter);
+    (void)status;
+  }
+  bench_timer_stop();
+  dsp_uninit(&filter);
+}
+
+static void bench_stdev_process(bench_t* b)
+{
+  bench_timer_stop();
+  dsp_filter_t filter = dsp_init(DSP_STDEV, STDEV_WINDOW);
+  bench_timer_start();
+  for(uint64_t ii = 0; ii < b->n; ii++)
+  {
+    filter.process(&filter.z, filter.dsp_parameter, (int16_t)(ii & 0x3FF));
+  }
+  bench_timer_stop();
+  dsp_uninit(&filter);
+}
+
+static void bench_stdev_read(bench_t* b)
+{
+  bench_timer_stop();
+  dsp_filter_t filter = dsp_init(DSP_STDEV, STDEV_WINDOW);
+  for(size_t ii = 0; ii < STDEV_WINDOW; ii++)
+  {
+    filter.process(&filter.z, filter.dsp_parameter, (int16_t)(ii * 31 % 17));
+  }
+  bench_timer_start();
+  for(uint64_t ii = 0; ii < b->n; ii++)
+  {
+    volatile int32_t value = filter.read(&filter.z, filter.dsp_parameter);
+    (void)value;
+  }
+  bench_timer_stop();
+  dsp_uninit(&filter);
+}
+
+/** Process and read each sample, as chain channels transmitting at sample rate do **/
+static void bench_filter(bench_t* b, ruuvi_dsp_function_t type)
+{
+  bench_timer_stop();
+  dsp_filter_t filter = dsp_init(type, STDEV_WINDOW);
+  bench_timer_start();
+  for(uint64_t ii = 0; ii < b->n; ii++)
+  {
+    filter.process(&filter.z, filter.dsp_parameter, (int16_t)((ii * 2654435761u) >> 16));
+    volatile int32_t value = filter.read(&filter.z, filter.dsp_parameter);
+    (void)value;
+  }
+  bench_timer_stop();
+  dsp_uninit(&filter);
+}
+
+static void bench_min(bench_t* b)       { bench_filter(b, DSP_MIN); }
+static void bench_average(bench_t* b)   { bench_filter(b, DSP_AVERAGE); }
+static void bench_impulse(bench_t* b)   { bench_filter(b, DSP_IMPULSE); }
+static void bench_low_pass(bench_t* b)  { bench_filter(b, DSP_LOW_PASS); }
+static void bench_high_pass(bench_t* b) { bench_filter(b, DSP_HIGH_PASS); }
+
+/** One 32-sample FIFO batch of 4 interleaved channels per op, as chain_block_handler **/
+static void bench_block(bench_t* b)
+{
+  bench_timer_stop();
+  int16_t samples[32 * 4];
+  for(size_t ii = 0; ii < sizeof(samples) / sizeof(samples[0]); ii++) { samples[ii] = (int16_t)(ii * 97); }
+  dsp_filter_t filters[4];
+  for(size_t ii = 0; ii < 4; ii++) { filters[ii] = dsp_init(DSP_AVERAGE, STDEV_WINDOW); }
+  bench_timer_start();
+  for(uint64_t ii = 0; ii < b->n; ii++)
+  {
+    for(size_t jj = 0; jj < 4; jj++) { dsp_process_block(&filters[jj], samples + jj, 32, 4); }
+  }
+  bench_timer_stop();
+  for(size_t ii = 0; ii < 4; ii++) { dsp_uninit(&filters[ii]); }
+}
+
+/** One 32-sample FIFO batch of x, y, z per op **/
+static void bench_fir(bench_t* b)
+{
+  bench_timer_stop();
+  static const int16_t taps[16] = {-200, -400, 0, 1200, 2800, 4200, 5000, 5200,
+                                   5200, 5000, 4200, 2800, 1200, 0, -400, -200};
+  static fir_q15_t fir;
+  int16_t samples[FIR_BLOCK_MAX * FIR_AXES];
+  for(size_t ii = 0; ii < sizeof(samples) / sizeof(samples[0]); ii++) { samples[ii] = (int16_t)(ii * 977); }
+  fir_q15_init(&fir, taps, 16);
+  bench_timer_start();
+  for(uint64_t ii = 0; ii < b->n; ii++)
+  {
+    fir_q15_process(&fir, samples, samples, FIR_BLOCK_MAX);
+  }
+  bench_timer_stop();
+}
+
+static void bench_biquad(bench_t* b)
+{
+  bench_timer_stop();
+  // 2nd order Butterworth low pass at 0.1 fs, Q14
+  static const int16_t coefficients[5] = {1105, 2210, 1105, -18727, 6763};
+  biquad_q14_t biquad;
+  int16_t samples[FIR_BLOCK_MAX * FIR_AXES];
+  for(size_t ii = 0; ii < sizeof(samples) / sizeof(samples[0]); ii++) { samples[ii] = (int16_t)(ii * 977); }
+  biquad_q14_init(&biquad, coefficients);
+  bench_timer_start();
+  for(uint64_t ii = 0; ii < b->n; ii++)
+  {
+    biquad_q14_process(&biquad, samples, samples, FIR_BLOCK_MAX);
+  }
+  bench_timer_stop();
+}
+
+/** Magnitude channel of one 32-sample batch of x, y, z, magnitude frames per op **/
+static void bench_vector(bench_t* b)
+{
+  bench_timer_stop();
+  int16_t samples[32][4];
+  for(size_t ii = 0; ii < 32; ii++)
+  {
+    for(size_t jj = 0; jj < 3; jj++) { samples[ii][jj] = (int16_t)((ii * 3 + jj) * 2713); }
+  }
+  bench_timer_start();
+  for(uint64_t ii = 0; ii < b->n; ii++)
+  {
+    dsp_vector_magnitude_block(samples[0], 32, 4, &samples[0][3], 4);
+    bench_keep(samples);
+  }
+  bench_timer_stop();
+}
+
+/** Door angle of one gravity vector against closed reference per op **/
+static void bench_vector_angle(bench_t* b)
+{
+  const int16_t reference[3] = { 12, -20, 1010 };
+  int16_t gravity[3] = { 0, 700, 700 };
+  for(uint64_t ii = 0; ii < b->n; ii++)
+  {
+    gravity[0] = (int16_t)(ii & 0xFF);
+    int16_t angle = dsp_vector_angle(reference, gravity);
+    bench_keep(&angle);
+  }
+}
+
+/** Four bins over one 32-sample batch of magnitude channel per op **/
+static void bench_goertzel(bench_t* b)
+{
+  bench_timer_stop();
+  static const uint8_t bins[4] = {2, 4, 6, 8};
+  goertzel_bank_t bank;
+  int16_t samples[32][4];
+  for(size_t ii = 0; ii < 32; ii++) { samples[ii][3] = (int16_t)(1000 + (ii & 7) * 300); }
+  goertzel_bank_init(&bank, bins, 4, 64);
+  bench_timer_start();
+  for(uint64_t ii = 0; ii < b->n; ii++)
+  {
+    goertzel_bank_process(&bank, &samples[0][3], 32, 4);
+  }
+  bench_timer_stop();
+  bench_keep(&bank);
+}
+
+static void bench_fft(bench_t* b)
+{
+  bench_timer_stop();
+  int16_t samples[FFT_LENGTH];
+  uint16_t amplitude[FFT_BINS];
+  for(size_t ii = 0; ii < FFT_LENGTH; ii++) { samples[ii] = (int16_t)(ii * 977); }
+  bench_timer_start();
+  for(uint64_t ii = 0; ii < b->n; ii++)
+  {
+    fft_q15_real64(samples, 1, amplitude);
+    bench_keep(amplitude);
+  }
+  bench_timer_stop();
+}
+
+const bench_case_t bench_dsp_cases[] = {
+  { "dsp_init+uninit/stdev/32",          bench_init_uninit },
+  { "dsp_is_init",                       bench_is_init },
+  { "dsp_process_stdev/32",              bench_stdev_process },
+  { "dsp_read_stdev/32",                 bench_stdev_read },
+  { "dsp_process+read/min/32",           bench_min },
+  { "dsp_process+read/average/32",       bench_average },
+  { "dsp_process+read/impulse/32",       bench_impulse },
+  { "dsp_process+read/low_pass/32",      bench_low_pass },
+  { "dsp_process+read/high_pass/32",     bench_high_pass },
+  { "dsp_process_block/average/32x4",    bench_block },
+  { "fir_q15_process/16taps/32x3",       bench_fir },
+  { "biquad_q14_process/32x3",           bench_biquad },
+  { "dsp_vector_magnitude_block/32",     bench_vector },
+  { "dsp_vector_angle",                  bench_vector_angle },
+  { "goertzel_bank_process/4bins/32",    bench_goertzel },
+  { "fft_q15_real64",                    bench_fft },
+  BENCH_CASES_END
+};
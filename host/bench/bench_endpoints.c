@@ -0,0 +1,92 @@
+#include "bench.h"
+#include "ruuvi_endpoints.h"
+
+static uint32_t m_handled = 0;
+
+static ret_code_t counting_handler(const ruuvi_standard_message_t message)
+{
+  m_handled += message.type;
+  return ENDPOINT_SUCCESS;
+}
+
+static const ruuvi_standard_message_t m_message = {
+  .destination_endpoint = ACCELERATION,
+  .source_endpoint      = ACCELERATION,
+  .type                 = SENSOR_CONFIGURATION,
+  .payload              = { 10, 1, 10, 2, DSP_STDEV, 8, TRANSMISSION_TARGET_BLE_GATT, 0 }
+};
+
+static void bench_route(bench_t* b)
+{
+  bench_timer_stop();
+  set_acceleration_handler(counting_handler);
+  bench_timer_start();
+  for(uint64_t ii = 0; ii < b->n; ii++)
+  {
+    route_message(m_message);
+  }
+  bench_timer_stop();
+  set_acceleration_handler(NULL);
+}
+
+static void bench_route_chain(bench_t* b)
+{
+  bench_timer_stop();
+  ruuvi_standard_message_t message = m_message;
+  message.destination_endpoint = 0x55;
+  set_chain_handler(counting_handler);
+  bench_timer_start();
+  for(uint64_t ii = 0; ii < b->n; ii++)
+  {
+    route_message(message);
+  }
+  bench_timer_stop();
+  set_chain_handler(NULL);
+}
+
+static void bench_unknown(bench_t* b)
+{
+  bench_timer_stop();
+  set_reply_handler(counting_handler);
+  bench_timer_start();
+  for(uint64_t ii = 0; ii < b->n; ii++)
+  {
+    volatile ret_code_t status = unknown_handler(m_message);
+    (void)status;
+  }
+  bench_timer_stop();
+  set_reply_handler(NULL);
+}
+
+static void bench_gatt_event(bench_t* b)
+{
+  bench_timer_stop();
+  set_acceleration_handler(counting_handler);
+  bench_timer_start();
+  for(uint64_t ii = 0; ii < b->n; ii++)
+  {
+    ble_gatt_scheduler_event_handler((void*)&m_message, sizeof(m_message));
+  }
+  bench_timer_stop();
+  set_acceleration_handler(NULL);
+}
+
+static void bench_handler_accessors(bench_t* b)
+{
+  for(uint64_t ii = 0; ii < b->n; ii++)
+  {
+    set_ble_gatt_handler(counting_handler);
+    volatile message_handler handler = get_ble_gatt_handler();
+    (void)handler;
+  }
+  set_ble_gatt_handler(NULL);
+}
+
+const bench_case_t bench_endpoints_cases[] = {
+  { "route_message/acceleration",        bench_route },
+  { "route_message/chain",               bench_route_chain },
+  { "unknown_handler",                   bench_unknown },
+  { "ble_gatt_scheduler_event_handler",  bench_gatt_event },
+  { "set+get_ble_gatt_handler",          bench_handler_accessors },
+  BENCH_CASES_END
+};
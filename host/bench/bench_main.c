@@ -0,0 +1,109 @@
+/**
+ *  Benchmark runner for the host build.
+ *
+ *  Usage: bench [filter]
+ *  Runs every benchmark whose name contains filter, or all if no filter is given.
+ *  Output is one line per benchmark: name, iterations, ns/op, bytes/op, allocs/op.
+ *  Set BENCH_TIME_MS to change the target duration of each benchmark, default 200.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "bench.h"
+
+#define BENCH_DEFAULT_TIME_MS 200
+#define BENCH_MAX_N           1000000000ULL
+
+static const bench_case_t* const m_suites[] = {
+  bench_ringbuffer_cases,
+  bench_dsp_cases,
+  bench_sensortag_cases,
+  bench_base64_cases,
+  bench_base91_cases,
+  bench_endpoints_cases,
+  bench_drivers_cases
+};
+
+static bool     m_running = false;
+static uint64_t m_start_ns = 0;
+static uint64_t m_elapsed_ns = 0;
+
+static uint64_t now_ns(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+void bench_timer_start(void)
+{
+  if(m_running) { return; }
+  m_running = true;
+  bench_alloc_enable(true);
+  m_start_ns = now_ns();
+}
+
+void bench_timer_stop(void)
+{
+  if(!m_running) { return; }
+  m_elapsed_ns += now_ns() - m_start_ns;
+  bench_alloc_enable(false);
+  m_running = false;
+}
+
+static void run_n(const bench_case_t* bench, uint64_t n)
+{
+  bench_t b = { .n = n };
+  m_elapsed_ns = 0;
+  bench_alloc_reset();
+  bench_timer_start();
+  bench->function(&b);
+  bench_timer_stop();
+}
+
+static void run_case(const bench_case_t* bench, uint64_t target_ns)
+{
+  uint64_t n = 1;
+  run_n(bench, n);
+  // Grow n until the run is long enough, predicting the required n from the previous run.
+  while(m_elapsed_ns < target_ns && n < BENCH_MAX_N)
+  {
+    uint64_t next = n * 100;
+    if(m_elapsed_ns > 0)
+    {
+      next = (target_ns * n) / m_elapsed_ns;
+      next += next / 5;
+    }
+    if(next < n + 1)      { next = n + 1; }
+    if(next > n * 100)    { next = n * 100; }
+    if(next > BENCH_MAX_N){ next = BENCH_MAX_N; }
+    n = next;
+    run_n(bench, n);
+  }
+
+  printf("%-40s %12llu %12.1f ns/op %8llu B/op %6llu allocs/op\n",
+         bench->name,
+         (unsigned long long)n,
+         (double)m_elapsed_ns / (double)n,
+         (unsigned long long)(bench_alloc_bytes() / n),
+         (unsigned long long)(bench_alloc_count() / n));
+}
+
+int main(int argc, char** argv)
+{
+  const char* filter = (argc > 1) ? argv[1] : NULL;
+  uint64_t target_ms = BENCH_DEFAULT_TIME_MS;
+  const char* env_time = getenv("BENCH_TIME_MS");
+  if(env_time) { target_ms = strtoull(env_time, NULL, 10); }
+
+  for(size_t ii = 0; ii < sizeof(m_suites) / sizeof(m_suites[0]); ii++)
+  {
+    for(const bench_case_t* bench = m_suites[ii]; bench->name; bench++)
+    {
+      if(filter && !strstr(bench->name, filter)) { continue; }
+      run_case(bench, target_ms * 1000000ULL);
+    }
+  }
+  return 0;
+}
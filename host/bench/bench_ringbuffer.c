@@ -0,0 +1,230 @@
+#include <string.h>
+#include "bench.h"
+#include "ringbuffer.h"
+
+#define RB_ELEMENTS 32
+
+static void fill(ringbuffer_t* buffer, size_t count)
+{
+  for(uint32_t ii = 0; ii < count; ii++)
+  {
+    uint32_t value = ii;
+    ringbuffer_push(buffer, &value);
+  }
+}
+
+static void bench_init_uninit(bench_t* b)
+{
+  ringbuffer_t buffer;
+  for(uint64_t ii = 0; ii < b->n; ii++)
+  {
+    ringbuffer_init(&buffer, RB_ELEMENTS, sizeof(uint32_t));
+    bench_keep(buffer.element);
+    ringbuffer_uninit(&buffer);
+  }
+}
+
+static void bench_push(bench_t* b)
+{
+  bench_timer_stop();
+  ringbuffer_t buffer;
+  ringbuffer_init(&buffer, RB_ELEMENTS, sizeof(uint32_t));
+  bench_timer_start();
+  for(uint64_t ii = 0; ii < b->n; ii++)
+  {
+    // Buffer stays full after first round, every push also pops the oldest element.
+    uint32_t value = (uint32_t)ii;
+    ringbuffer_push(&buffer, &value);
+  }
+  bench_timer_stop();
+  ringbuffer_uninit(&buffer);
+}
+
+static void bench_push_static(bench_t* b)
+{
+  RINGBUFFER_DEF(buffer, uint32_t, RB_ELEMENTS);
+  for(uint64_t ii = 0; ii < b->n; ii++)
+  {
+    uint32_t value = (uint32_t)ii;
+    ringbuffer_push(&buffer, &value);
+  }
+  bench_keep(buffer.element);
+}
+
+static void bench_push_popqueue(bench_t* b)
+{
+  bench_timer_stop();
+  ringbuffer_t buffer;
+  ringbuffer_init(&buffer, RB_ELEMENTS, sizeof(uint32_t));
+  fill(&buffer, RB_ELEMENTS / 2);
+  bench_timer_start();
+  for(uint64_t ii = 0; ii < b->n; ii++)
+  {
+    uint32_t value = (uint32_t)ii;
+    ringbuffer_push(&buffer, &value);
+    ringbuffer_popqueue(&buffer, &value);
+    bench_keep(&value);
+  }
+  bench_timer_stop();
+  ringbuffer_uninit(&buffer);
+}
+
+static void bench_push_popstack(bench_t* b)
+{
+  bench_timer_stop();
+  ringbuffer_t buffer;
+  ringbuffer_init(&buffer, RB_ELEMENTS, sizeof(uint32_t));
+  fill(&buffer, RB_ELEMENTS / 2);
+  bench_timer_start();
+  for(uint64_t ii = 0; ii < b->n; ii++)
+  {
+    uint32_t value = (uint32_t)ii;
+    ringbuffer_push(&buffer, &value);
+    ringbuffer_popstack(&buffer, &value);
+    bench_keep(&value);
+  }
+  bench_timer_stop();
+  ringbuffer_uninit(&buffer);
+}
+
+static void bench_peek_at(bench_t* b)
+{
+  bench_timer_stop();
+  ringbuffer_t buffer;
+  ringbuffer_init(&buffer, RB_ELEMENTS, sizeof(uint32_t));
+  fill(&buffer, RB_ELEMENTS + RB_ELEMENTS / 2);
+  bench_timer_start();
+  for(uint64_t ii = 0; ii < b->n; ii++)
+  {
+    uint32_t value;
+    ringbuffer_peek_at(&buffer, ii % RB_ELEMENTS, &value);
+    bench_keep(&value);
+  }
+  bench_timer_stop();
+  ringbuffer_uninit(&buffer);
+}
+
+static void bench_status(bench_t* b)
+{
+  bench_timer_stop();
+  ringbuffer_t buffer;
+  ringbuffer_init(&buffer, RB_ELEMENTS, sizeof(uint32_t));
+  fill(&buffer, RB_ELEMENTS / 2);
+  bench_timer_start();
+  for(uint64_t ii = 0; ii < b->n; ii++)
+  {
+    volatile size_t status = ringbuffer_full(&buffer) + ringbuffer_empty(&buffer)
+                           + ringbuffer_is_init(&buffer) + ringbuffer_get_size(&buffer)
+                           + ringbuffer_get_count(&buffer);
+    (void)status;
+  }
+  bench_timer_stop();
+  ringbuffer_uninit(&buffer);
+}
+
+static void bench_copy_data(bench_t* b)
+{
+  bench_timer_stop();
+  ringbuffer_t buffer;
+  uint32_t target[RB_ELEMENTS];
+  ringbuffer_init(&buffer, RB_ELEMENTS, sizeof(uint32_t));
+  fill(&buffer, RB_ELEMENTS + RB_ELEMENTS / 2);
+  bench_timer_start();
+  for(uint64_t ii = 0; ii < b->n; ii++)
+  {
+    ringbuffer_copy_data(target, &buffer);
+    bench_keep(target);
+  }
+  bench_timer_stop();
+  ringbuffer_uninit(&buffer);
+}
+
+static void bench_push_n_pop_n(bench_t* b)
+{
+  RINGBUFFER_DEF(buffer, uint32_t, RB_ELEMENTS);
+  uint32_t values[RB_ELEMENTS / 2] = { 0 };
+  fill(&buffer, RB_ELEMENTS / 4);
+  for(uint64_t ii = 0; ii < b->n; ii++)
+  {
+    ringbuffer_push_n(&buffer, values, RB_ELEMENTS / 2);
+    ringbuffer_pop_n(&buffer, values, RB_ELEMENTS / 2);
+    bench_keep(values);
+  }
+}
+
+static void bench_spans_sum(bench_t* b)
+{
+  // Sum stored elements in place, compare with peek_at loop
+  RINGBUFFER_DEF(buffer, uint32_t, RB_ELEMENTS);
+  fill(&buffer, RB_ELEMENTS + RB_ELEMENTS / 2);
+  for(uint64_t ii = 0; ii < b->n; ii++)
+  {
+    ringbuffer_span_t spans[2];
+    size_t num_spans = ringbuffer_spans(&buffer, spans);
+    uint32_t sum = 0;
+    for(size_t jj = 0; jj < num_spans; jj++)
+    {
+      const uint32_t* values = spans[jj].data;
+      for(size_t kk = 0; kk < spans[jj].count; kk++) { sum += values[kk]; }
+    }
+    bench_keep(&sum);
+  }
+}
+
+static void bench_peek_at_sum(bench_t* b)
+{
+  RINGBUFFER_DEF(buffer, uint32_t, RB_ELEMENTS);
+  fill(&buffer, RB_ELEMENTS + RB_ELEMENTS / 2);
+  for(uint64_t ii = 0; ii < b->n; ii++)
+  {
+    uint32_t sum = 0;
+    for(size_t jj = 0; jj < ringbuffer_get_count(&buffer); jj++)
+    {
+      uint32_t value;
+      ringbuffer_peek_at(&buffer, jj, &value);
+      sum += value;
+    }
+    bench_keep(&sum);
+  }
+}
+
+static void bench_spsc_push_pop(bench_t* b)
+{
+  RINGBUFFER_SPSC_DEF(buffer, uint32_t, RB_ELEMENTS);
+  for(uint64_t ii = 0; ii < b->n; ii++)
+  {
+    uint32_t value = (uint32_t)ii;
+    ringbuffer_spsc_push(&buffer, &value);
+    ringbuffer_spsc_pop(&buffer, &value);
+    bench_keep(&value);
+  }
+}
+
+static void bench_spsc_burst(bench_t* b)
+{
+  // Interrupt burst fills the ring, main loop drains it.
+  RINGBUFFER_SPSC_DEF(buffer, uint16_t, RB_ELEMENTS);
+  for(uint64_t ii = 0; ii < b->n; ii++)
+  {
+    uint16_t value = (uint16_t)ii;
+    for(size_t jj = 0; jj < RB_ELEMENTS; jj++) { ringbuffer_spsc_push(&buffer, &value); }
+    while(ringbuffer_spsc_pop(&buffer, &value)) { bench_keep(&value); }
+  }
+}
+
+const bench_case_t bench_ringbuffer_cases[] = {
+  { "ringbuffer_init+uninit/32xu32",     bench_init_uninit },
+  { "ringbuffer_push/full/32xu32",       bench_push },
+  { "ringbuffer_push/static/32xu32",     bench_push_static },
+  { "ringbuffer_push+popqueue/32xu32",   bench_push_popqueue },
+  { "ringbuffer_push+popstack/32xu32",   bench_push_popstack },
+  { "ringbuffer_peek_at/32xu32",         bench_peek_at },
+  { "ringbuffer_status/5 calls",         bench_status },
+  { "ringbuffer_copy_data/32xu32",       bench_copy_data },
+  { "ringbuffer_push_n+pop_n/16xu32",    bench_push_n_pop_n },
+  { "ringbuffer_spans/sum 32xu32",       bench_spans_sum },
+  { "ringbuffer_peek_at/sum 32xu32",     bench_peek_at_sum },
+  { "ringbuffer_spsc_push+pop/32xu32",   bench_spsc_push_pop },
+  { "ringbuffer_spsc_burst/32xu16",      bench_spsc_burst },
+  BENCH_CASES_END
+};
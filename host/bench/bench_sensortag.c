@@ -0,0 +1,63 @@
+#include <string.h>
+#include "bench.h"
+#include "sensortag.h"
+
+static const ruuvi_sensor_t m_data = {
+  .format      = RAW_FORMAT_2,
+  .humidity    = 45 * 1024,
+  .temperature = 2134,
+  .pressure    = 101325 << 8,
+  .accX        = -12,
+  .accY        = 35,
+  .accZ        = 1005,
+  .vbat        = 2950
+};
+
+static void bench_raw3(bench_t* b)
+{
+  uint8_t buffer[SENSORTAG_ENCODED_DATA_LENGTH];
+  for(uint64_t ii = 0; ii < b->n; ii++)
+  {
+    encodeToRawFormat3(buffer, &m_data);
+    bench_keep(buffer);
+  }
+}
+
+static void bench_raw5(bench_t* b)
+{
+  uint8_t buffer[RAW_2_ENCODED_DATA_LENGTH];
+  for(uint64_t ii = 0; ii < b->n; ii++)
+  {
+    encodeToRawFormat5(buffer, &m_data, (uint16_t)ii, 4);
+    bench_keep(buffer);
+  }
+}
+
+static void bench_sw_raw5(bench_t* b)
+{
+  uint8_t buffer[RAW_2_ENCODED_DATA_LENGTH];
+  for(uint64_t ii = 0; ii < b->n; ii++)
+  {
+    encodeToSWRawFormat5(buffer, &m_data, (uint16_t)ii, 4, ii & 1);
+    bench_keep(buffer);
+  }
+}
+
+static void bench_url(bench_t* b)
+{
+  char url[EDDYSTONE_URL_MAX_LENGTH + 1] = { 0x03, 'r', 'u', 'u', '.', 'v', 'i', '/', '#' };
+  ruuvi_sensor_t data = m_data;
+  for(uint64_t ii = 0; ii < b->n; ii++)
+  {
+    encodeToUrlDataFromat(url, URL_BASE_MAX_LENGTH, &data);
+    bench_keep(url);
+  }
+}
+
+const bench_case_t bench_sensortag_cases[] = {
+  { "encodeToRawFormat3",                bench_raw3 },
+  { "encodeToRawFormat5",                bench_raw5 },
+  { "encodeToSWRawFormat5",              bench_sw_raw5 },
+  { "encodeToUrlDataFromat",             bench_url },
+  BENCH_CASES_END
+};
@@ -0,0 +1,155 @@
+/**
+ *  Error of the 32-bit BME280 pressure compensation against the 64-bit one.
+ *
+ *  Runs bme280_compensate_P_int32 and bme280_compensate_P_int64 of
+ *  drivers/bme280/bme280.c on the same inputs and reports the difference in Pa.
+ *  Pressure calibration is swept over every corner of the coefficient ranges
+ *  below plus the typical part of devices/bme280_model.c, temperature over the
+ *  operating range and pressure ADC over the full 20-bit range. Points where the
+ *  64-bit result is outside the 300 ... 1100 hPa operating range are counted
+ *  but not compared, the sensor is not specified there.
+ *
+ *  Usage: bme280_compensation [adc_step]
+ *  Pressure ADC step, default 1024. Step 1 compares every ADC value and takes minutes.
+ */
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "bme280.h"
+
+#define DEFAULT_ADC_STEP     1024
+#define ADC_MAX              0xFFFFF
+#define ADC_T_STEP           2048
+#define TEMPERATURE_MIN      (-4000)  // 0.01 C
+#define TEMPERATURE_MAX      8500
+#define PRESSURE_MIN         (30000 << 8)  // Q24.8 Pa
+#define PRESSURE_MAX         (110000 << 8)
+#define PRESSURE_COEFFICIENTS 9
+
+/** Temperature calibration of the typical part, only sets t_fine for the sweep */
+static const uint16_t m_dig_T1 = 27504;
+static const int16_t  m_dig_T2 = 26435;
+static const int16_t  m_dig_T3 = -1000;
+
+/** Typical part, dig_P1 ... dig_P9 */
+static const int32_t m_typical[PRESSURE_COEFFICIENTS] = {36477, -10685, 3024, 2855, 140, -7, 15500, -14600, 6000};
+
+/** Approximate spread of pressure coefficients between parts, dig_P1 ... dig_P9 */
+static const int32_t m_min[PRESSURE_COEFFICIENTS] = {34000, -11000, 2500, 1500, -300, -10,  9900, -14600, 4000};
+static const int32_t m_max[PRESSURE_COEFFICIENTS] = {39000, -10000, 3500, 10000, 300,  -4, 15500, -10000, 6000};
+
+typedef struct
+{
+  uint64_t compared;
+  uint64_t skipped;
+  uint64_t above_1pa;
+  double   total;
+  double   max;
+  int32_t  max_adc_p;
+  int32_t  max_temperature;
+  uint32_t max_pressure;
+  int32_t  max_set;
+} error_stats_t;
+
+static void set_calibration(const int32_t* p)
+{
+  bme280.cp.dig_T1 = m_dig_T1;
+  bme280.cp.dig_T2 = m_dig_T2;
+  bme280.cp.dig_T3 = m_dig_T3;
+  bme280.cp.dig_P1 = p[0];
+  bme280.cp.dig_P2 = p[1];
+  bme280.cp.dig_P3 = p[2];
+  bme280.cp.dig_P4 = p[3];
+  bme280.cp.dig_P5 = p[4];
+  bme280.cp.dig_P6 = p[5];
+  bme280.cp.dig_P7 = p[6];
+  bme280.cp.dig_P8 = p[7];
+  bme280.cp.dig_P9 = p[8];
+}
+
+/** Compare both variants over temperature and pressure ADC range with current calibration */
+static void compare(error_stats_t* stats, int32_t set, uint32_t adc_step)
+{
+  for(int32_t adc_t = 0; adc_t <= ADC_MAX; adc_t += ADC_T_STEP)
+  {
+    bme280.adc_t = adc_t;
+    int32_t temperature = bme280_get_temperature();  // Updates t_fine
+    if(temperature < TEMPERATURE_MIN || temperature > TEMPERATURE_MAX) { continue; }
+    for(int32_t adc_p = 0; adc_p <= ADC_MAX; adc_p += adc_step)
+    {
+      uint32_t reference = bme280_compensate_P_int64(adc_p);
+      if(reference < PRESSURE_MIN || reference > PRESSURE_MAX)
+      {
+        stats->skipped++;
+        continue;
+      }
+      double error = ((double)bme280_compensate_P_int32(adc_p) - reference) / 256;
+      if(error < 0) { error = -error; }
+      stats->compared++;
+      stats->total += error;
+      if(error > 1) { stats->above_1pa++; }
+      if(error > stats->max)
+      {
+        stats->max = error;
+        stats->max_adc_p = adc_p;
+        stats->max_temperature = temperature;
+        stats->max_pressure = reference >> 8;
+        stats->max_set = set;
+      }
+    }
+  }
+}
+
+static void print_stats(const char* name, const error_stats_t* stats)
+{
+  printf("%-16s %12"PRIu64" %12"PRIu64" %10.3f %10.3f %12"PRIu64"\n", name, stats->compared, stats->skipped,
+         stats->compared ? stats->total / stats->compared : 0, stats->max, stats->above_1pa);
+}
+
+int main(int argc, char** argv)
+{
+  uint32_t adc_step = DEFAULT_ADC_STEP;
+  if(argc > 1) { adc_step = strtoul(argv[1], NULL, 0); }
+  if(0 == adc_step)
+  {
+    fprintf(stderr, "Usage: %s [adc_step]\n", argv[0]);
+    return 1;
+  }
+
+  error_stats_t typical = {0};
+  error_stats_t corners = {0};
+  set_calibration(m_typical);
+  compare(&typical, -1, adc_step);
+
+  int32_t coefficients[PRESSURE_COEFFICIENTS];
+  for(int32_t set = 0; set < (1 << PRESSURE_COEFFICIENTS); set++)
+  {
+    for(size_t ii = 0; ii < PRESSURE_COEFFICIENTS; ii++)
+    {
+      coefficients[ii] = (set & (1 << ii)) ? m_max[ii] : m_min[ii];
+    }
+    set_calibration(coefficients);
+    compare(&corners, set, adc_step);
+  }
+
+  printf("Pressure ADC step %"PRIu32", temperature %d ... %d C\n\n", adc_step,
+         TEMPERATURE_MIN / 100, TEMPERATURE_MAX / 100);
+  printf("%-16s %12s %12s %10s %10s %12s\n", "calibration", "compared", "skipped", "mean Pa", "max Pa", "over 1 Pa");
+  print_stats("typical", &typical);
+  print_stats("range corners", &corners);
+
+  const error_stats_t* worst = (typical.max > corners.max) ? &typical : &corners;
+  printf("\nMaximum error %.3f Pa at %"PRIu32" Pa, %.2f C, adc_P 0x%05"PRIx32", ", worst->max,
+         worst->max_pressure, worst->max_temperature / 100.0, (uint32_t)worst->max_adc_p);
+  if(worst->max_set < 0) { printf("typical part\n"); }
+  else
+  {
+    printf("corner");
+    for(size_t ii = 0; ii < PRESSURE_COEFFICIENTS; ii++)
+    {
+      printf(" %s", (worst->max_set & (1 << ii)) ? "max" : "min");
+    }
+    printf(" (dig_P1 ... dig_P9)\n");
+  }
+  return 0;
+}
@@ -0,0 +1,220 @@
+#include <stdbool.h>
+#include <string.h>
+#include "bme280_model.h"
+#include "bme280.h"
+#include "host_clock.h"
+
+#define REGISTERS        0x80
+#define ADDRESS_MASK     0x7F
+#define SPI_READ         0x80
+#define RESET_WORD       0xB6
+#define STATUS_MEASURING 0x08
+#define MODE_MASK        0x03
+
+#define REG(address)     ((address) & ADDRESS_MASK)
+
+static uint8_t  m_reg[REGISTERS];
+static uint8_t  m_osrs_h;
+static bool     m_measuring;
+static uint64_t m_conversion_end_us;
+static uint64_t m_next_start_us;
+static int32_t  m_adc_t;
+static int32_t  m_adc_p;
+static int32_t  m_adc_h;
+static uint32_t m_conversions;
+
+/** Calibration of a typical part, little endian words from 0x88 and humidity block from 0xE1 */
+static const int32_t m_calib_tp[12] = {27504, 26435, -1000, 36477, -10685, 3024, 2855, 140, -7, 15500, -14600, 6000};
+static const uint8_t m_calib_h1 = 75;
+static const int16_t m_calib_h2 = 362;
+static const uint8_t m_calib_h3 = 0;
+static const int16_t m_calib_h4 = 324;
+static const int16_t m_calib_h5 = 0;
+static const int8_t  m_calib_h6 = 30;
+
+/** Standby time by CONFIG t_sb in microseconds */
+static const uint32_t m_standby_us[8] = {500, 62500, 125000, 250000, 500000, 1000000, 10000, 20000};
+
+static uint8_t oversampling(uint8_t osrs)
+{
+  if(0 == osrs) { return 0; }
+  if(osrs > 5)  { return 16; }
+  return 1 << (osrs - 1);
+}
+
+uint32_t bme280_model_conversion_time_us(void)
+{
+  uint8_t ctrl_meas = m_reg[REG(BME280REG_CTRL_MEAS)];
+  uint32_t t = oversampling(ctrl_meas >> 5);
+  uint32_t p = oversampling((ctrl_meas >> 2) & 0x07);
+  uint32_t h = oversampling(m_osrs_h);
+  // Datasheet maximum: 1.25 + 2.3 T + (2.3 P + 0.575) + (2.3 H + 0.575) ms
+  uint32_t us = 1250 + 2300 * t;
+  if(p) { us += 2300 * p + 575; }
+  if(h) { us += 2300 * h + 575; }
+  return us;
+}
+
+static void put20(uint8_t address, int32_t value, bool enabled)
+{
+  if(!enabled) { value = 0x80000; }
+  m_reg[REG(address)]     = (value >> 12) & 0xFF;
+  m_reg[REG(address) + 1] = (value >> 4) & 0xFF;
+  m_reg[REG(address) + 2] = (value << 4) & 0xF0;
+}
+
+static void latch_results(void)
+{
+  uint8_t ctrl_meas = m_reg[REG(BME280REG_CTRL_MEAS)];
+  put20(BME280REG_PRESS_MSB, m_adc_p, (ctrl_meas >> 2) & 0x07);
+  put20(BME280REG_TEMP_MSB, m_adc_t, ctrl_meas >> 5);
+  int32_t h = m_osrs_h ? m_adc_h : 0x8000;
+  m_reg[REG(BME280REG_HUM_MSB)] = (h >> 8) & 0xFF;
+  m_reg[REG(BME280REG_HUM_LSB)] = h & 0xFF;
+  m_conversions++;
+}
+
+static void start_conversion(uint64_t start_us)
+{
+  m_measuring = true;
+  m_conversion_end_us = start_us + bme280_model_conversion_time_us();
+}
+
+/** Run conversions that have ended by now */
+static void advance(void)
+{
+  uint64_t now = host_clock_now_us();
+  while(true)
+  {
+    if(m_measuring)
+    {
+      if(m_conversion_end_us > now) { return; }
+      m_measuring = false;
+      latch_results();
+      uint8_t mode = m_reg[REG(BME280REG_CTRL_MEAS)] & MODE_MASK;
+      if(MODE_MASK == mode)
+      {
+        m_next_start_us = m_conversion_end_us + m_standby_us[m_reg[REG(BME280REG_CONFIG)] >> 5];
+      }
+      else
+      {
+        // Forced mode returns to sleep after one conversion
+        m_reg[REG(BME280REG_CTRL_MEAS)] &= ~MODE_MASK;
+      }
+    }
+    else if(MODE_MASK == (m_reg[REG(BME280REG_CTRL_MEAS)] & MODE_MASK) && m_next_start_us <= now)
+    {
+      // Skip whole periods that ended long ago, only the last result is visible
+      uint64_t period = bme280_model_conversion_time_us() + m_standby_us[m_reg[REG(BME280REG_CONFIG)] >> 5];
+      uint64_t skipped = (now - m_next_start_us) / period;
+      m_conversions += skipped;
+      start_conversion(m_next_start_us + skipped * period);
+    }
+    else
+    {
+      return;
+    }
+  }
+}
+
+static void load_defaults(void)
+{
+  memset(m_reg, 0, sizeof(m_reg));
+  m_reg[REG(BME280REG_ID)] = BME280_ID_VALUE;
+  for(int ii = 0; ii < 12; ii++)
+  {
+    m_reg[REG(BME280REG_CALIB_00) + 2 * ii]     = (uint16_t)m_calib_tp[ii] & 0xFF;
+    m_reg[REG(BME280REG_CALIB_00) + 2 * ii + 1] = (uint16_t)m_calib_tp[ii] >> 8;
+  }
+  m_reg[REG(0xA1)] = m_calib_h1;
+  m_reg[REG(0xE1)] = (uint16_t)m_calib_h2 & 0xFF;
+  m_reg[REG(0xE2)] = (uint16_t)m_calib_h2 >> 8;
+  m_reg[REG(0xE3)] = m_calib_h3;
+  m_reg[REG(0xE4)] = (m_calib_h4 >> 4) & 0xFF;
+  m_reg[REG(0xE5)] = (m_calib_h4 & 0x0F) | ((m_calib_h5 & 0x0F) << 4);
+  m_reg[REG(0xE6)] = (m_calib_h5 >> 4) & 0xFF;
+  m_reg[REG(0xE7)] = m_calib_h6;
+  put20(BME280REG_PRESS_MSB, 0, false);
+  put20(BME280REG_TEMP_MSB, 0, false);
+  m_reg[REG(BME280REG_HUM_MSB)] = 0x80;
+  m_osrs_h = 0;
+  m_measuring = false;
+  m_conversion_end_us = 0;
+  m_next_start_us = 0;
+}
+
+static void write_register(uint8_t address, uint8_t value)
+{
+  switch(address | SPI_READ)
+  {
+    case BME280REG_RESET:
+      if(RESET_WORD == value) { load_defaults(); }
+      break;
+
+    case BME280REG_CTRL_HUM:
+      m_reg[REG(address)] = value & 0x07;
+      break;
+
+    case BME280REG_CTRL_MEAS:
+      m_reg[REG(address)] = value;
+      m_osrs_h = m_reg[REG(BME280REG_CTRL_HUM)];
+      if((value & MODE_MASK) && !m_measuring)
+      {
+        start_conversion(host_clock_now_us());
+      }
+      break;
+
+    case BME280REG_CONFIG:
+      m_reg[REG(address)] = value & 0xFD;
+      break;
+
+    default:
+      // Other registers are read only
+      break;
+  }
+}
+
+void bme280_model_reset(void)
+{
+  load_defaults();
+  m_adc_t = 519888;
+  m_adc_p = 415148;
+  m_adc_h = 30000;
+  m_conversions = 0;
+}
+
+void bme280_model_transfer(const uint8_t* p_tx, uint8_t* p_rx, uint8_t count)
+{
+  if(0 == count) { return; }
+  advance();
+  p_rx[0] = 0xFF;
+  if(p_tx[0] & SPI_READ)
+  {
+    uint8_t address = REG(p_tx[0]);
+    for(int ii = 1; ii < count; ii++)
+    {
+      p_rx[ii] = m_reg[address];
+      if(REG(BME280REG_STATUS) == address) { p_rx[ii] = m_measuring ? STATUS_MEASURING : 0; }
+      address = REG(address + 1);
+    }
+    return;
+  }
+  // Writes are address, data pairs, address bit 7 is cleared on each pair
+  memset(p_rx, 0xFF, count);
+  for(int ii = 0; ii + 1 < count; ii += 2)
+  {
+    write_register(REG(p_tx[ii]), p_tx[ii + 1]);
+  }
+}
+
+void bme280_model_set_raw(int32_t adc_t, int32_t adc_p, int32_t adc_h)
+{
+  m_adc_t = adc_t;
+  m_adc_p = adc_p;
+  m_adc_h = adc_h;
+}
+
+uint32_t bme280_model_conversions(void)
+{
+  return m_conversions;
+}
@@ -0,0 +1,30 @@
+/**
+ *  Register level model of BME280 on SPI.
+ *
+ *  Holds a fixed calibration block and ID, applies CTRL_HUM on the next
+ *  CTRL_MEAS write, runs forced and normal mode conversions on host_clock
+ *  with datasheet maximum conversion times, reports them in STATUS and
+ *  latches raw ADC values into the data registers when a conversion ends.
+ *  IIR filter is not modelled, raw values are what the source gives.
+ */
+#ifndef BME280_MODEL_H
+#define BME280_MODEL_H
+
+#include <stdint.h>
+
+/** Return to power-on state with default raw values */
+void bme280_model_reset(void);
+
+/** Handle one chip-select framed transfer */
+void bme280_model_transfer(const uint8_t* p_tx, uint8_t* p_rx, uint8_t count);
+
+/** Set raw ADC values latched by following conversions */
+void bme280_model_set_raw(int32_t adc_t, int32_t adc_p, int32_t adc_h);
+
+/** Duration of one conversion with current oversampling in microseconds */
+uint32_t bme280_model_conversion_time_us(void);
+
+/** Number of completed conversions since reset */
+uint32_t bme280_model_conversions(void);
+
+#endif
@@ -0,0 +1,449 @@
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include "lis2dh12_model.h"
+#include "lis2dh12_registers.h"
+#include "host_clock.h"
+
+#define REGISTERS      0x40
+#define FIFO_DEPTH     32
+#define SPI_READ       0x80
+#define SPI_ADR_INC    0x40
+#define ADDRESS_MASK   0x3F
+/** Samples produced when catching up with a long time step, older samples would be overwritten anyway */
+#define MAX_CATCH_UP   (2 * FIFO_DEPTH)
+
+/* Bits not in lis2dh12_registers.h */
+#define I1_ZYXDA       0x10
+#define I2_IA1         0x40
+#define I2_IA2         0x20
+#define TR_INT2        0x20
+#define AOI_IA         0x40
+
+static uint8_t  m_reg[REGISTERS];
+static int16_t  m_out[3];
+static int16_t  m_fifo[FIFO_DEPTH][3];
+static uint8_t  m_fifo_head;
+static uint8_t  m_fifo_count;
+static bool     m_fifo_overrun;
+static bool     m_triggered;
+static uint8_t  m_status;
+static int32_t  m_reference[3];
+static int32_t  m_last_mg[3];
+static uint8_t  m_aoi_position[2];
+static uint64_t m_next_sample_us;
+static uint8_t  m_pin_level[2];
+static uint8_t  m_pending_edges;
+static int32_t  m_constant_mg[3];
+static lis2dh12_model_source_t    m_source;
+static lis2dh12_model_interrupt_t m_handler;
+
+/** mg per digit by full scale, in low power, normal and high resolution mode */
+static const uint8_t m_sensitivity[3][4] = {
+  {16, 32, 64, 192},
+  {4,  8,  16, 48 },
+  {1,  2,  4,  12 }
+};
+
+/** Interrupt threshold LSB in mg by full scale */
+static const uint8_t m_threshold_lsb[4] = {16, 32, 62, 186};
+
+static bool is_writable(uint8_t address)
+{
+  switch(address)
+  {
+    case 0x1E:
+    case LIS2DH12_TEMP_CFG_REG:
+    case LIS2DH12_CTRL_REG1:
+    case LIS2DH12_CTRL_REG2:
+    case LIS2DH12_CTRL_REG3:
+    case LIS2DH12_CTRL_REG4:
+    case LIS2DH12_CTRL_REG5:
+    case LIS2DH12_CTRL_REG6:
+    case LIS2DH12_REFERENCE:
+    case LIS2DH12_FIFO_CTRL_REG:
+    case LIS2DH12_INT1_CFG:
+    case LIS2DH12_INT1_THS:
+    case LIS2DH12_INT1_DURATION:
+    case LIS2DH12_INT2_CFG:
+    case LIS2DH12_INT2_THS:
+    case LIS2DH12_INT2_DURATION:
+    case LIS2DH12_CLICK_CFG:
+    case LIS2DH12_CLICK_THS:
+    case LIS2DH12_TIME_LIMIT:
+    case LIS2DH12_TIME_LATENCY:
+    case LIS2DH12_TIME_WINDOW:
+    case LIS2DH12_ACT_THS:
+    case LIS2DH12_ACT_DUR:
+      return true;
+
+    default:
+      return false;
+  }
+}
+
+static uint32_t sample_rate_hz(void)
+{
+  static const uint16_t rates[16] = {0, 1, 10, 25, 50, 100, 200, 400, 1620, 1344};
+  uint8_t odr = m_reg[LIS2DH12_CTRL_REG1] >> 4;
+  if(9 == odr && (m_reg[LIS2DH12_CTRL_REG1] & LIS2DH12_LPEN_MASK)) { return 5376; }
+  return rates[odr];
+}
+
+/** 0: low power 8 bit, 1: normal 10 bit, 2: high resolution 12 bit */
+static uint8_t operating_mode(void)
+{
+  if(m_reg[LIS2DH12_CTRL_REG1] & LIS2DH12_LPEN_MASK) { return 0; }
+  if(m_reg[LIS2DH12_CTRL_REG4] & LIS2DH12_HR_MASK)   { return 2; }
+  return 1;
+}
+
+static uint8_t full_scale(void)
+{
+  return (m_reg[LIS2DH12_CTRL_REG4] & LIS2DH12_FS_MASK) >> 4;
+}
+
+static uint8_t fifo_mode(void)
+{
+  return m_reg[LIS2DH12_FIFO_CTRL_REG] & LIS2DH12_FM_MASK;
+}
+
+static bool fifo_enabled(void)
+{
+  return (m_reg[LIS2DH12_CTRL_REG5] & LIS2DH12_FIFO_EN_MASK) && (0 != fifo_mode());
+}
+
+static void fifo_clear(void)
+{
+  m_fifo_head = 0;
+  m_fifo_count = 0;
+  m_fifo_overrun = false;
+  m_triggered = false;
+}
+
+static void fifo_push(const int16_t* sample)
+{
+  bool stream = (LIS2DH12_FM_STREAM == fifo_mode()) ||
+                ((LIS2DH12_FM_STREAM | LIS2DH12_FM_FIFO) == fifo_mode() && !m_triggered);
+  if(FIFO_DEPTH == m_fifo_count)
+  {
+    m_fifo_overrun = true;
+    if(!stream) { return; }
+    m_fifo_head = (m_fifo_head + 1) % FIFO_DEPTH;
+    m_fifo_count--;
+  }
+  memcpy(m_fifo[(m_fifo_head + m_fifo_count) % FIFO_DEPTH], sample, sizeof(m_fifo[0]));
+  m_fifo_count++;
+}
+
+static uint8_t fifo_source(void)
+{
+  uint8_t src = (m_fifo_count > 31) ? 31 : m_fifo_count;
+  if(m_fifo_count > (m_reg[LIS2DH12_FIFO_CTRL_REG] & LIS2DH12_FTH_MASK)) { src |= LIS2DH12_WTM_MASK; }
+  if(m_fifo_overrun)     { src |= LIS2DH12_OVRN_FIFO_MASK; }
+  if(0 == m_fifo_count)  { src |= LIS2DH12_EMPTY_MASK; }
+  return src;
+}
+
+/**
+ * Evaluate AOI interrupt generator 0 or 1 on one sample.
+ * 6D movement fires when the set of exceeded directions changes, 6D position
+ * while a direction is exceeded. Otherwise magnitudes are OR- or AND-combined.
+ */
+static void aoi_evaluate(uint8_t function, const int32_t* mg)
+{
+  uint8_t cfg_reg = function ? LIS2DH12_INT2_CFG : LIS2DH12_INT1_CFG;
+  uint8_t src_reg = function ? LIS2DH12_INT2_SOURCE : LIS2DH12_INT1_SOURCE;
+  uint8_t ths_reg = function ? LIS2DH12_INT2_THS : LIS2DH12_INT1_THS;
+  uint8_t hp_mask = function ? LIS2DH12_HPIS2_MASK : LIS2DH12_HPIS1_MASK;
+  uint8_t lir_mask = function ? LIS2DH12_LIR_INT2_MASK : LIS2DH12_LIR_INT1_MASK;
+  uint8_t cfg = m_reg[cfg_reg];
+  uint8_t enables = cfg & 0x3F;
+  int32_t threshold = (m_reg[ths_reg] & 0x7F) * m_threshold_lsb[full_scale()];
+  bool six_d = cfg & LIS2DH12_6D_MASK;
+  bool and_combination = cfg & LIS2DH12_AOI_MASK;
+  uint8_t bits = 0;
+
+  for(int axis = 0; axis < 3; axis++)
+  {
+    int32_t value = mg[axis];
+    if(m_reg[LIS2DH12_CTRL_REG2] & hp_mask) { value -= m_reference[axis]; }
+    if(six_d)
+    {
+      if(value >  threshold) { bits |= 2 << (2 * axis); }
+      if(value < -threshold) { bits |= 1 << (2 * axis); }
+    }
+    else
+    {
+      bits |= ((abs(value) > threshold) ? 2 : 1) << (2 * axis);
+    }
+  }
+  bits &= enables;
+
+  bool active;
+  if(six_d && !and_combination)     { active = (0 != bits) && (bits != m_aoi_position[function]); }
+  else if(six_d)                    { active = (0 != bits); }
+  else if(and_combination)          { active = (0 != enables) && (bits == enables); }
+  else                              { active = (0 != bits); }
+  m_aoi_position[function] = bits;
+
+  bool latched = (m_reg[LIS2DH12_CTRL_REG5] & lir_mask) && (m_reg[src_reg] & AOI_IA);
+  if(latched) { return; }
+  m_reg[src_reg] = bits | (active ? AOI_IA : 0);
+
+  uint8_t trigger = (m_reg[LIS2DH12_FIFO_CTRL_REG] & TR_INT2) ? 1 : 0;
+  if(active && trigger == function) { m_triggered = true; }
+}
+
+static void update_pins(void)
+{
+  bool ia1 = m_reg[LIS2DH12_INT1_SOURCE] & AOI_IA;
+  bool ia2 = m_reg[LIS2DH12_INT2_SOURCE] & AOI_IA;
+  uint8_t ctrl3 = m_reg[LIS2DH12_CTRL_REG3];
+  uint8_t ctrl6 = m_reg[LIS2DH12_CTRL_REG6];
+  uint8_t fifo = fifo_source();
+  uint8_t level[2];
+
+  level[0] = ((ctrl3 & LIS2DH12_I1_IA1) && ia1) ||
+             ((ctrl3 & LIS2DH12_I1_IA2) && ia2) ||
+             ((ctrl3 & I1_ZYXDA) && (m_status & LIS2DH12_ZYXDA_MASK)) ||
+             ((ctrl3 & LIS2DH12_I1_WTM) && fifo_enabled() && (fifo & LIS2DH12_WTM_MASK)) ||
+             ((ctrl3 & LIS2DH12_I1_OVERRUN) && fifo_enabled() && (fifo & LIS2DH12_OVRN_FIFO_MASK));
+  level[1] = ((ctrl6 & I2_IA1) && ia1) ||
+             ((ctrl6 & I2_IA2) && ia2);
+
+  for(int pin = 0; pin < 2; pin++)
+  {
+    if(level[pin] && !m_pin_level[pin]) { m_pending_edges |= 1 << pin; }
+    m_pin_level[pin] = level[pin];
+  }
+}
+
+static void produce_sample(uint64_t time_us)
+{
+  int32_t mg[3] = {m_constant_mg[0], m_constant_mg[1], m_constant_mg[2]};
+  if(NULL != m_source) { m_source(time_us, mg); }
+
+  uint8_t mode = operating_mode();
+  uint8_t shift = 8 - 2 * mode;
+  int32_t limit = 1 << (7 + 2 * mode);
+  uint8_t sensitivity = m_sensitivity[mode][full_scale()];
+  int16_t sample[3];
+  for(int axis = 0; axis < 3; axis++)
+  {
+    int32_t digits = mg[axis] / sensitivity;
+    if(digits >  limit - 1) { digits = limit - 1; }
+    if(digits < -limit)     { digits = -limit; }
+    if(!(m_reg[LIS2DH12_CTRL_REG1] & (LIS2DH12_X_EN_MASK << axis))) { digits = 0; }
+    sample[axis] = (int16_t)(digits * (1 << shift));
+    // Output data is quantised, interrupt generators see the same values
+    mg[axis] = digits * sensitivity;
+  }
+
+  if(m_status & LIS2DH12_ZYXDA_MASK) { m_status |= LIS2DH12_ZYXOR_MASK | LIS2DH12_XOR_MASK | LIS2DH12_YOR_MASK | LIS2DH12_ZOR_MASK; }
+  m_status |= LIS2DH12_ZYXDA_MASK | LIS2DH12_XDA_MASK | LIS2DH12_YDA_MASK | LIS2DH12_ZDA_MASK;
+  memcpy(m_out, sample, sizeof(m_out));
+  if(fifo_enabled()) { fifo_push(sample); }
+
+  aoi_evaluate(0, mg);
+  aoi_evaluate(1, mg);
+  for(int axis = 0; axis < 3; axis++)
+  {
+    // Normal mode high-pass with the largest cutoff, reference tracks DC
+    m_reference[axis] += (mg[axis] - m_reference[axis]) / 8;
+    m_last_mg[axis] = mg[axis];
+  }
+  update_pins();
+}
+
+static void schedule_first_sample(void)
+{
+  uint32_t hz = sample_rate_hz();
+  m_next_sample_us = hz ? host_clock_now_us() + 1000000 / hz : 0;
+}
+
+static void advance(void)
+{
+  uint32_t hz = sample_rate_hz();
+  if(0 == hz || 0 == m_next_sample_us) { return; }
+  uint64_t period = 1000000 / hz;
+  uint64_t now = host_clock_now_us();
+  if(m_next_sample_us > now) { return; }
+
+  uint64_t due = (now - m_next_sample_us) / period + 1;
+  if(due > MAX_CATCH_UP) { m_next_sample_us += (due - MAX_CATCH_UP) * period; }
+  while(m_next_sample_us <= now)
+  {
+    produce_sample(m_next_sample_us);
+    m_next_sample_us += period;
+  }
+}
+
+static uint8_t read_output(uint8_t address)
+{
+  const int16_t* sample = m_out;
+  bool from_fifo = fifo_enabled() && m_fifo_count;
+  if(from_fifo) { sample = m_fifo[m_fifo_head]; }
+  uint8_t offset = address - LIS2DH12_OUT_X_L;
+  uint8_t value = (uint16_t)sample[offset / 2] >> (8 * (offset % 2));
+
+  if(LIS2DH12_OUT_Z_H == address)
+  {
+    m_status = 0;
+    if(from_fifo)
+    {
+      m_fifo_head = (m_fifo_head + 1) % FIFO_DEPTH;
+      m_fifo_count--;
+      m_fifo_overrun = false;
+    }
+  }
+  return value;
+}
+
+static uint8_t read_register(uint8_t address)
+{
+  uint8_t value;
+  switch(address)
+  {
+    case LIS2DH12_OUT_X_L:
+    case LIS2DH12_OUT_X_H:
+    case LIS2DH12_OUT_Y_L:
+    case LIS2DH12_OUT_Y_H:
+    case LIS2DH12_OUT_Z_L:
+    case LIS2DH12_OUT_Z_H:
+      return read_output(address);
+
+    case LIS2DH12_STATUS_REG:
+      return m_status;
+
+    case LIS2DH12_FIFO_SRC_REG:
+      return fifo_source();
+
+    case LIS2DH12_REFERENCE:
+      // Reading REFERENCE resets high-pass filter to current acceleration
+      memcpy(m_reference, m_last_mg, sizeof(m_reference));
+      return m_reg[address];
+
+    case LIS2DH12_INT1_SOURCE:
+    case LIS2DH12_INT2_SOURCE:
+      value = m_reg[address];
+      m_reg[address] &= ~AOI_IA;
+      return value;
+
+    default:
+      return m_reg[address];
+  }
+}
+
+static void write_register(uint8_t address, uint8_t value)
+{
+  if(!is_writable(address)) { return; }
+  uint8_t previous = m_reg[address];
+  m_reg[address] = value;
+
+  switch(address)
+  {
+    case LIS2DH12_CTRL_REG1:
+      if((previous ^ value) & LIS2DH12_ODR_MASK) { schedule_first_sample(); }
+      break;
+
+    case LIS2DH12_CTRL_REG5:
+      // BOOT reloads trimming values and clears itself
+      m_reg[address] &= ~LIS2DH12_BOOT_MASK;
+      if(!(value & LIS2DH12_FIFO_EN_MASK)) { fifo_clear(); }
+      break;
+
+    case LIS2DH12_FIFO_CTRL_REG:
+      if(0 == fifo_mode()) { fifo_clear(); }
+      if((previous ^ value) & LIS2DH12_FM_MASK) { m_triggered = false; }
+      break;
+
+    default:
+      break;
+  }
+}
+
+void lis2dh12_model_reset(void)
+{
+  memset(m_reg, 0, sizeof(m_reg));
+  m_reg[LIS2DH12_WHO_AM_I] = LIS2DH12_I_AM_MASK;
+  m_reg[0x1E] = 0x10;
+  m_reg[LIS2DH12_CTRL_REG1] = LIS2DH12_XYZ_EN_MASK;
+  memset(m_out, 0, sizeof(m_out));
+  memset(m_reference, 0, sizeof(m_reference));
+  memset(m_last_mg, 0, sizeof(m_last_mg));
+  memset(m_aoi_position, 0, sizeof(m_aoi_position));
+  memset(m_pin_level, 0, sizeof(m_pin_level));
+  fifo_clear();
+  m_status = 0;
+  m_next_sample_us = 0;
+  m_pending_edges = 0;
+  m_constant_mg[0] = 0;
+  m_constant_mg[1] = 0;
+  m_constant_mg[2] = 1000;
+  m_source = NULL;
+  m_handler = NULL;
+}
+
+void lis2dh12_model_transfer(const uint8_t* p_tx, uint8_t* p_rx, size_t count)
+{
+  if(0 == count) { return; }
+  advance();
+  uint8_t address = p_tx[0] & ADDRESS_MASK;
+  bool read = p_tx[0] & SPI_READ;
+  bool increment = p_tx[0] & SPI_ADR_INC;
+  if(p_rx) { p_rx[0] = 0xFF; }
+
+  for(size_t ii = 1; ii < count; ii++)
+  {
+    uint8_t value = 0xFF;
+    if(read) { value = read_register(address); }
+    else     { write_register(address, p_tx[ii]); }
+    if(p_rx) { p_rx[ii] = value; }
+    if(!increment) { continue; }
+    // Output registers wrap around while FIFO is in use so that FIFO can be read in one burst
+    if(LIS2DH12_OUT_Z_H == address && fifo_enabled()) { address = LIS2DH12_OUT_X_L; }
+    else { address = (address + 1) & ADDRESS_MASK; }
+  }
+  update_pins();
+}
+
+void lis2dh12_model_set_acceleration(int32_t x, int32_t y, int32_t z)
+{
+  m_constant_mg[0] = x;
+  m_constant_mg[1] = y;
+  m_constant_mg[2] = z;
+}
+
+void lis2dh12_model_set_source(lis2dh12_model_source_t source)
+{
+  m_source = source;
+}
+
+void lis2dh12_model_set_interrupt_handler(lis2dh12_model_interrupt_t handler)
+{
+  m_handler = handler;
+}
+
+void lis2dh12_model_update(void)
+{
+  advance();
+  update_pins();
+  uint8_t edges = m_pending_edges;
+  m_pending_edges = 0;
+  for(uint8_t pin = 0; pin < 2; pin++)
+  {
+    if((edges & (1 << pin)) && NULL != m_handler) { m_handler(pin + 1); }
+  }
+}
+
+uint8_t lis2dh12_model_interrupt_level(uint8_t pin)
+{
+  if(1 != pin && 2 != pin) { return 0; }
+  return m_pin_level[pin - 1];
+}
+
+uint8_t lis2dh12_model_register(uint8_t address)
+{
+  return m_reg[address & ADDRESS_MASK];
+}
@@ -0,0 +1,51 @@
+/**
+ *  Register level model of LIS2DH12 on SPI.
+ *
+ *  Models the parts of the device the driver uses: CTRL_REG1..6, output
+ *  registers with auto-increment, 32-sample FIFO in bypass, FIFO, stream and
+ *  stream-to-FIFO modes with watermark and overrun flags, and the two AOI
+ *  interrupt generators with optional high-pass filter.
+ *  Samples are produced at the configured data rate from host_clock.
+ *  Click detection and temperature sensor are not modelled.
+ */
+#ifndef LIS2DH12_MODEL_H
+#define LIS2DH12_MODEL_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/** Acceleration in mg on each axis at given time */
+typedef void (*lis2dh12_model_source_t)(uint64_t time_us, int32_t mg[3]);
+
+/** Called on rising edge of interrupt pin 1 or 2 */
+typedef void (*lis2dh12_model_interrupt_t)(uint8_t pin);
+
+/** Return to power-on state. Constant 1 g on Z, no interrupt handler. */
+void lis2dh12_model_reset(void);
+
+/** Handle one chip-select framed transfer, p_rx may be NULL for writes */
+void lis2dh12_model_transfer(const uint8_t* p_tx, uint8_t* p_rx, size_t count);
+
+/** Set constant acceleration in mg */
+void lis2dh12_model_set_acceleration(int32_t x, int32_t y, int32_t z);
+
+/** Set time-varying acceleration, NULL returns to constant acceleration */
+void lis2dh12_model_set_source(lis2dh12_model_source_t source);
+
+/** Set interrupt pin handler */
+void lis2dh12_model_set_interrupt_handler(lis2dh12_model_interrupt_t handler);
+
+/**
+ *  Produce samples up to current host_clock time and report interrupt edges
+ *  to handler. Transfers update state too, but defer handler calls to here so
+ *  that the handler may use the driver.
+ */
+void lis2dh12_model_update(void);
+
+/** Level of interrupt pin 1 or 2, before polarity inversion */
+uint8_t lis2dh12_model_interrupt_level(uint8_t pin);
+
+/** Raw register value, for inspection by tools */
+uint8_t lis2dh12_model_register(uint8_t address);
+
+#endif
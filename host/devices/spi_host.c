@@ -0,0 +1,83 @@
+#include <stddef.h>
+#include <string.h>
+#include "spi_host.h"
+#include "lis2dh12_model.h"
+#include "bme280_model.h"
+#include "boards.h"
+#include "trace.h"
+
+static bool m_initialized = false;
+static spi_host_stats_t m_stats[SPI_HOST_DEVICES];
+
+// Command and data phases of a split read are one transfer for the model
+static uint8_t m_read_tx[1 + UINT8_MAX];
+static uint8_t m_read_rx[1 + UINT8_MAX];
+
+static void account(spi_host_device_t device, size_t count)
+{
+  m_stats[device].transactions++;
+  m_stats[device].bytes += count;
+}
+
+void spi_init(void)
+{
+  m_initialized = true;
+}
+
+bool spi_isInitialized(void)
+{
+  return m_initialized;
+}
+
+SPI_Ret spi_transfer_bme280(uint8_t* const p_toWrite, uint8_t count, uint8_t* const p_toRead)
+{
+  if((NULL == p_toWrite) || (NULL == p_toRead)) { return SPI_RET_ERROR; }
+  account(SPI_HOST_BME280, count);
+  TRACE_EVENT(TRACE_SPI_START, (SPIM0_SS_HUMI_PIN << 8) | count);
+  bme280_model_transfer(p_toWrite, p_toRead, count);
+  TRACE_EVENT(TRACE_SPI_STOP, (SPIM0_SS_HUMI_PIN << 8) | count);
+  return SPI_RET_OK;
+}
+
+SPI_Ret spi_transfer_lis2dh12(uint8_t* const p_toWrite, uint8_t count, uint8_t* const p_toRead)
+{
+  if(NULL == p_toWrite) { return SPI_RET_ERROR; }
+  account(SPI_HOST_LIS2DH12, count);
+  TRACE_EVENT(TRACE_SPI_START, (SPIM0_SS_ACC_PIN << 8) | count);
+  lis2dh12_model_transfer(p_toWrite, p_toRead, count);
+  TRACE_EVENT(TRACE_SPI_STOP, (SPIM0_SS_ACC_PIN << 8) | count);
+  return SPI_RET_OK;
+}
+
+SPI_Ret spi_read_lis2dh12(uint8_t* const p_command, uint8_t count, uint8_t* const p_toRead)
+{
+  if((NULL == p_command) || (NULL == p_toRead)) { return SPI_RET_ERROR; }
+  account(SPI_HOST_LIS2DH12, count + 1);
+  TRACE_EVENT(TRACE_SPI_START, (SPIM0_SS_ACC_PIN << 8) | (uint8_t)(count + 1));
+  m_read_tx[0] = p_command[0];
+  lis2dh12_model_transfer(m_read_tx, m_read_rx, count + 1);
+  memcpy(p_toRead, &m_read_rx[1], count);
+  TRACE_EVENT(TRACE_SPI_STOP, (SPIM0_SS_ACC_PIN << 8) | (uint8_t)(count + 1));
+  return SPI_RET_OK;
+}
+
+void spi_host_reset(void)
+{
+  lis2dh12_model_reset();
+  bme280_model_reset();
+  spi_host_stats_reset();
+}
+
+void spi_host_stats_reset(void)
+{
+  for(size_t ii = 0; ii < SPI_HOST_DEVICES; ii++)
+  {
+    m_stats[ii].transactions = 0;
+    m_stats[ii].bytes = 0;
+  }
+}
+
+spi_host_stats_t spi_host_stats_get(spi_host_device_t device)
+{
+  return m_stats[device];
+}
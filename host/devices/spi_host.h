@@ -0,0 +1,36 @@
+/**
+ *  Host implementation of drivers/spi/spi.h.
+ *
+ *  Routes transfers to the register models of LIS2DH12 and BME280 and counts
+ *  transactions and bytes per device so that bus traffic of driver code can be
+ *  measured without hardware.
+ */
+#ifndef SPI_HOST_H
+#define SPI_HOST_H
+
+#include <stdint.h>
+#include "spi.h"
+
+typedef enum
+{
+  SPI_HOST_BME280 = 0,
+  SPI_HOST_LIS2DH12,
+  SPI_HOST_DEVICES
+} spi_host_device_t;
+
+typedef struct
+{
+  uint32_t transactions;  /**< Chip select assertions */
+  uint32_t bytes;         /**< Bytes clocked, including address byte */
+} spi_host_stats_t;
+
+/** Reset device models to power-on state and clear statistics */
+void spi_host_reset(void);
+
+/** Clear statistics */
+void spi_host_stats_reset(void);
+
+/** Statistics of given device since last reset */
+spi_host_stats_t spi_host_stats_get(spi_host_device_t device);
+
+#endif
@@ -0,0 +1,260 @@
+/**
+ *  Bit-exactness check of the Q15 FIR and Q14 biquad kernels in libraries/dsp.
+ *
+ *  Runs fir_q15_process and biquad_q14_process twice: built with the portable
+ *  C of dsp_simd.h, and built again with __ARM_FEATURE_DSP so that the
+ *  kernels go through the CMSIS SMLAD / SMUAD / SSAT path, here the
+ *  instruction definitions in shims/nrf.h. Both are compared against a direct
+ *  int64 evaluation of the difference equation on random full scale input,
+ *  fed in uneven blocks and partly in place. Coefficients are drawn within the
+ *  no-overflow bounds of fir.h and biquad.h; beyond the bounds, where the
+ *  accumulator wraps, only the two kernel builds are compared with each other.
+ *
+ *  Usage: dsp_check [rounds]
+ *  Exits with 1 on the first mismatch.
+ */
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "fir.h"
+#include "biquad.h"
+
+#define DEFAULT_ROUNDS 2000
+#define SAMPLES_MAX    200
+
+/** Kernels built with __ARM_FEATURE_DSP, see host/Makefile */
+bool simd_fir_q15_init(fir_q15_t* fir, const int16_t* coefficients, const size_t taps);
+void simd_fir_q15_process(fir_q15_t* fir, const int16_t* input, int16_t* output, size_t count);
+bool simd_biquad_q14_init(biquad_q14_t* biquad, const int16_t coefficients[5]);
+void simd_biquad_q14_process(biquad_q14_t* biquad, const int16_t* input, int16_t* output, size_t count);
+
+static uint32_t m_random = 0x2545F491;
+
+static uint32_t random_u32(void)
+{
+  // xorshift32
+  m_random ^= m_random << 13;
+  m_random ^= m_random >> 17;
+  m_random ^= m_random << 5;
+  return m_random;
+}
+
+/** Random int16, every 8th value full scale to hit saturation */
+static int16_t random_sample(void)
+{
+  uint32_t r = random_u32();
+  if(0 == (r & 0x7)) { return (r & 0x8) ? INT16_MAX : INT16_MIN; }
+  return (int16_t)(r >> 16);
+}
+
+/** Random value in [-max, max] */
+static int32_t random_range(int32_t max)
+{
+  return (int32_t)(random_u32() % (2 * (uint32_t)max + 1)) - max;
+}
+
+static int16_t saturate(int64_t x)
+{
+  if(x > INT16_MAX) { return INT16_MAX; }
+  if(x < INT16_MIN) { return INT16_MIN; }
+  return (int16_t)x;
+}
+
+/** Random coefficients with sum of absolute values at most limit, none below -max */
+static void random_coefficients(int16_t* coefficients, size_t count, int32_t max, int32_t limit)
+{
+  int32_t sum = 0;
+  for(size_t ii = 0; ii < count; ii++)
+  {
+    int32_t budget = limit - sum;
+    if(budget > max) { budget = max; }
+    int32_t c = budget ? random_range(budget) : 0;
+    coefficients[ii] = (int16_t)c;
+    sum += abs(c);
+  }
+  // Shuffle so that the large ones are not always first
+  for(size_t ii = count - 1; ii > 0; ii--)
+  {
+    size_t jj = random_u32() % (ii + 1);
+    int16_t tmp = coefficients[ii];
+    coefficients[ii] = coefficients[jj];
+    coefficients[jj] = tmp;
+  }
+}
+
+/** Process count frames in random block sizes, every other block in place */
+typedef void (*process_fn)(void* state, const int16_t* input, int16_t* output, size_t count);
+
+static void process_blocks(process_fn process, void* state, const int16_t* input, int16_t* output, size_t count)
+{
+  size_t done = 0;
+  while(done < count)
+  {
+    size_t n = 1 + random_u32() % 40;
+    if(n > count - done) { n = count - done; }
+    const int16_t* in = input + done * FIR_AXES;
+    int16_t* out = output + done * FIR_AXES;
+    if(random_u32() & 1)
+    {
+      memcpy(out, in, n * FIR_AXES * sizeof(int16_t));
+      in = out;
+    }
+    process(state, in, out, n);
+    done += n;
+  }
+}
+
+static void fir_portable(void* state, const int16_t* input, int16_t* output, size_t count)
+{
+  fir_q15_process(state, input, output, count);
+}
+
+static void fir_simd(void* state, const int16_t* input, int16_t* output, size_t count)
+{
+  simd_fir_q15_process(state, input, output, count);
+}
+
+static void biquad_portable(void* state, const int16_t* input, int16_t* output, size_t count)
+{
+  biquad_q14_process(state, input, output, count);
+}
+
+static void biquad_simd(void* state, const int16_t* input, int16_t* output, size_t count)
+{
+  simd_biquad_q14_process(state, input, output, count);
+}
+
+static void fir_reference(const int16_t* h, size_t taps, const int16_t* input, int16_t* output, size_t count)
+{
+  for(size_t axis = 0; axis < FIR_AXES; axis++)
+  {
+    for(size_t n = 0; n < count; n++)
+    {
+      int64_t acc = 1 << 14;
+      for(size_t k = 0; k < taps && k <= n; k++)
+      {
+        acc += (int64_t)h[k] * input[(n - k) * FIR_AXES + axis];
+      }
+      output[n * FIR_AXES + axis] = saturate(acc >> 15);
+    }
+  }
+}
+
+static void biquad_reference(const int16_t c[5], const int16_t* input, int16_t* output, size_t count)
+{
+  for(size_t axis = 0; axis < FIR_AXES; axis++)
+  {
+    int64_t x1 = 0, x2 = 0, y1 = 0, y2 = 0;
+    for(size_t n = 0; n < count; n++)
+    {
+      int64_t x0 = input[n * FIR_AXES + axis];
+      int64_t acc = c[0] * x0 + c[1] * x1 + c[2] * x2 - c[3] * y1 - c[4] * y2 + (1 << 13);
+      int16_t y0 = saturate(acc >> 14);
+      output[n * FIR_AXES + axis] = y0;
+      x2 = x1;
+      x1 = x0;
+      y2 = y1;
+      y1 = y0;
+    }
+  }
+}
+
+/** Returns index of first differing value, -1 if equal */
+static int32_t first_difference(const int16_t* a, const int16_t* b, size_t count)
+{
+  for(size_t ii = 0; ii < count * FIR_AXES; ii++)
+  {
+    if(a[ii] != b[ii]) { return ii; }
+  }
+  return -1;
+}
+
+static bool report(const char* what, uint32_t round, const int16_t* expected, const int16_t* actual, size_t count)
+{
+  int32_t ii = first_difference(expected, actual, count);
+  if(ii < 0) { return true; }
+  printf("FAIL %s, round %"PRIu32": frame %"PRId32" axis %"PRId32" expected %d, got %d\n", what, round,
+         ii / FIR_AXES, ii % FIR_AXES, expected[ii], actual[ii]);
+  return false;
+}
+
+static bool check_fir(uint32_t round)
+{
+  int16_t h[FIR_TAPS_MAX];
+  size_t taps = 1 + random_u32() % FIR_TAPS_MAX;
+  random_coefficients(h, taps, INT16_MAX, 32768);
+  size_t count = 1 + random_u32() % SAMPLES_MAX;
+  int16_t input[SAMPLES_MAX * FIR_AXES];
+  int16_t expected[SAMPLES_MAX * FIR_AXES];
+  int16_t portable[SAMPLES_MAX * FIR_AXES];
+  int16_t simd[SAMPLES_MAX * FIR_AXES];
+  for(size_t ii = 0; ii < count * FIR_AXES; ii++) { input[ii] = random_sample(); }
+
+  static fir_q15_t fir;
+  fir_reference(h, taps, input, expected, count);
+  fir_q15_init(&fir, h, taps);
+  process_blocks(fir_portable, &fir, input, portable, count);
+  simd_fir_q15_init(&fir, h, taps);
+  process_blocks(fir_simd, &fir, input, simd, count);
+  return report("fir portable", round, expected, portable, count) &&
+         report("fir simd", round, expected, simd, count);
+}
+
+static bool check_biquad(uint32_t round)
+{
+  int16_t c[5];
+  // Within the bound of biquad.h every round, beyond it every 4th round
+  bool bounded = (round & 3);
+  if(bounded) { random_coefficients(c, 5, INT16_MAX, 65535); }
+  else        { for(size_t ii = 0; ii < 5; ii++) { c[ii] = (int16_t)random_range(INT16_MAX); } }
+  size_t count = 1 + random_u32() % SAMPLES_MAX;
+  int16_t input[SAMPLES_MAX * FIR_AXES];
+  int16_t expected[SAMPLES_MAX * FIR_AXES];
+  int16_t portable[SAMPLES_MAX * FIR_AXES];
+  int16_t simd[SAMPLES_MAX * FIR_AXES];
+  for(size_t ii = 0; ii < count * FIR_AXES; ii++) { input[ii] = random_sample(); }
+
+  biquad_q14_t biquad;
+  biquad_q14_init(&biquad, c);
+  process_blocks(biquad_portable, &biquad, input, portable, count);
+  simd_biquad_q14_init(&biquad, c);
+  process_blocks(biquad_simd, &biquad, input, simd, count);
+  if(!report("biquad simd vs portable", round, portable, simd, count)) { return false; }
+  if(!bounded) { return true; }
+  biquad_reference(c, input, expected, count);
+  return report("biquad portable", round, expected, portable, count);
+}
+
+static bool check_biquad_init(void)
+{
+  biquad_q14_t biquad;
+  const int16_t a1_min[5] = {16384, 0, 0, INT16_MIN, 0};
+  const int16_t a2_min[5] = {16384, 0, 0, 0, INT16_MIN};
+  const int16_t valid[5]  = {16384, 0, 0, INT16_MAX, INT16_MAX};
+  if(biquad_q14_init(&biquad, a1_min) || biquad_q14_init(&biquad, a2_min) || !biquad_q14_init(&biquad, valid))
+  {
+    printf("FAIL biquad_q14_init range check\n");
+    return false;
+  }
+  return true;
+}
+
+int main(int argc, char** argv)
+{
+  uint32_t rounds = DEFAULT_ROUNDS;
+  if(argc > 1) { rounds = strtoul(argv[1], NULL, 0); }
+  if(0 == rounds)
+  {
+    fprintf(stderr, "Usage: %s [rounds]\n", argv[0]);
+    return 1;
+  }
+  if(!check_biquad_init()) { return 1; }
+  for(uint32_t round = 0; round < rounds; round++)
+  {
+    if(!check_fir(round) || !check_biquad(round)) { return 1; }
+  }
+  printf("fir_q15 and biquad_q14: %"PRIu32" rounds, portable and SIMD builds match int64 reference\n", rounds);
+  return 0;
+}
@@ -0,0 +1,256 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "energy_model.h"
+
+// Firmware configuration
+#include "bluetooth_application_config.h"
+#include "application_config.h"
+
+#ifndef BLE_TX_POWER
+  #define BLE_TX_POWER APP_TX_POWER  // drivers/init/bluetooth_config.h
+#endif
+
+#define PARAMETER(name) { #name, offsetof(energy_config_t, name) }
+
+const energy_parameter_t energy_parameters[] = {
+  PARAMETER(main_interval_ms),
+  PARAMETER(adv_interval_ms),
+  PARAMETER(adv_startup_ms),
+  PARAMETER(adv_startup_interval_ms),
+  PARAMETER(adv_pdu_bytes),
+  PARAMETER(adv_channels),
+  PARAMETER(tx_power_dbm),
+  PARAMETER(battery_interval_ms),
+  PARAMETER(bme_present),
+  PARAMETER(bme_standby_ms),
+  PARAMETER(bme_forced),
+  PARAMETER(bme_osrs_t),
+  PARAMETER(bme_osrs_p),
+  PARAMETER(bme_osrs_h),
+  PARAMETER(lis_present),
+  PARAMETER(lis_rate_hz),
+  PARAMETER(lis_resolution_bits),
+  PARAMETER(switch_nc),
+  PARAMETER(door_opens_per_day),
+  PARAMETER(door_open_s),
+  PARAMETER(acc_events_per_hour),
+  PARAMETER(sim_days),
+  PARAMETER(seed),
+  PARAMETER(task_cpu_us),
+  PARAMETER(task_spi_transactions),
+  PARAMETER(task_spi_bytes),
+  PARAMETER(isr_cpu_us),
+  PARAMETER(sched_cpu_us),
+  PARAMETER(vdd_v),
+  PARAMETER(sleep_ua),
+  PARAMETER(cpu_ma),
+  PARAMETER(spi_ma),
+  PARAMETER(spi_overhead_us),
+  PARAMETER(spi_byte_us),
+  PARAMETER(saadc_ma),
+  PARAMETER(saadc_us),
+  PARAMETER(radio_overhead_ma),
+  PARAMETER(radio_overhead_us),
+  PARAMETER(radio_rampup_ma),
+  PARAMETER(radio_rampup_us),
+  PARAMETER(radio_gap_us),
+  PARAMETER(led_ma),
+  PARAMETER(bme_sleep_ua),
+  PARAMETER(bme_t_ma),
+  PARAMETER(bme_p_ma),
+  PARAMETER(bme_h_ma),
+  PARAMETER(lis_powerdown_ua),
+  PARAMETER(pullup_kohm),
+  PARAMETER(battery_mah),
+  PARAMETER(battery_derating),
+  PARAMETER(battery_self_discharge_pct_year),
+};
+const size_t energy_parameters_count = sizeof(energy_parameters) / sizeof(energy_parameters[0]);
+
+const char* const energy_consumer_names[ENERGY_CONSUMERS] = {
+  [ENERGY_SLEEP]    = "sleep",
+  [ENERGY_CPU]      = "cpu",
+  [ENERGY_SPI]      = "spi",
+  [ENERGY_SAADC]    = "saadc",
+  [ENERGY_RADIO]    = "radio",
+  [ENERGY_LED]      = "led",
+  [ENERGY_BME280]   = "bme280",
+  [ENERGY_LIS2DH12] = "lis2dh12",
+  [ENERGY_PULLUP]   = "reed pull-up"
+};
+
+static double bme280_standby_ms(enum BME280_INTERVAL interval)
+{
+  switch(interval)
+  {
+    case BME280_STANDBY_0_5_MS:  return 0.5;
+    case BME280_STANDBY_62_5_MS: return 62.5;
+    case BME280_STANDBY_125_MS:  return 125;
+    case BME280_STANDBY_500_MS:  return 500;
+    case BME280_STANDBY_1000_MS: return 1000;
+    default: return 1000;
+  }
+}
+
+/** Register value to number of samples, 0 = skipped */
+static double bme280_oversampling(uint8_t os)
+{
+  return (BME280_OVERSAMPLING_SKIP == os) ? 0 : (double)(1 << (os - 1));
+}
+
+static double lis2dh12_rate_hz(lis2dh12_sample_rate_t rate)
+{
+  switch(rate)
+  {
+    case LIS2DH12_RATE_0:   return 0;
+    case LIS2DH12_RATE_1:   return 1;
+    case LIS2DH12_RATE_10:  return 10;
+    case LIS2DH12_RATE_25:  return 25;
+    case LIS2DH12_RATE_50:  return 50;
+    case LIS2DH12_RATE_100: return 100;
+    case LIS2DH12_RATE_200: return 200;
+    case LIS2DH12_RATE_400: return 400;
+    default: return 0;
+  }
+}
+
+void energy_config_default(energy_config_t* config)
+{
+  memset(config, 0, sizeof(*config));
+  config->main_interval_ms        = MAIN_LOOP_INTERVAL_RAW;
+  config->adv_interval_ms         = ADVERTISING_INTERVAL_RAW;
+  config->adv_startup_ms          = ADVERTISING_STARTUP_PERIOD;
+  config->adv_startup_interval_ms = ADVERTISING_INTERVAL_STARTUP;
+  // preamble 1, access address 4, header 2, AdvA 6, flags 3, manufacturer data 4 + RAWv2, CRC 3
+  config->adv_pdu_bytes           = 1 + 4 + 2 + 6 + 3 + 4 + RAWv2_DATA_LENGTH + 3;
+  config->adv_channels            = 3;
+  config->tx_power_dbm            = BLE_TX_POWER;
+  config->battery_interval_ms     = APPLICATION_BATTERY_INTERVAL;
+  config->bme_present             = 1;
+  config->bme_standby_ms          = bme280_standby_ms(BME280_DELAY);
+  config->bme_forced              = APPLICATION_BME280_FORCED_ENABLED;
+  config->bme_osrs_t              = bme280_oversampling(BME280_TEMPERATURE_OVERSAMPLING);
+  config->bme_osrs_p              = bme280_oversampling(BME280_PRESSURE_OVERSAMPLING);
+  config->bme_osrs_h              = bme280_oversampling(BME280_HUMIDITY_OVERSAMPLING);
+  config->lis_present             = 1;
+  // Rate the accelerometer runs at between events, see ACC_IDLE_SAMPLERATE in main.c
+#if APPLICATION_CAPTURE_ENABLED
+  config->lis_rate_hz             = lis2dh12_rate_hz(LIS2DH12_SAMPLERATE_CAPTURE);
+#elif APPLICATION_KNOCK_ENABLED
+  config->lis_rate_hz             = lis2dh12_rate_hz(LIS2DH12_SAMPLERATE_KNOCK);
+#else
+  config->lis_rate_hz             = lis2dh12_rate_hz(LIS2DH12_SAMPLERATE_RAWv1);
+#endif
+  config->lis_resolution_bits     = 16 - LIS2DH12_RESOLUTION;
+  config->switch_nc               = 0;  // main.c switch_type default NO
+
+  config->door_opens_per_day      = 20;
+  config->door_open_s             = 30;
+  config->acc_events_per_hour     = 10;
+  config->sim_days                = 7;
+  config->seed                    = 1;
+
+  config->task_cpu_us             = 350;
+  config->task_spi_transactions   = 3;   // BME280 burst, LIS2DH12 sample
+  config->task_spi_bytes          = 9 + 9 + 7;
+  config->isr_cpu_us              = 15;
+  config->sched_cpu_us            = 30;
+
+  config->vdd_v                   = 3.0;
+  config->sleep_ua                = 1.9;
+  config->cpu_ma                  = 3.7;
+  config->spi_ma                  = 1.1;
+  config->spi_overhead_us         = 8;
+  config->spi_byte_us             = 1;
+  config->saadc_ma                = 0.7;
+  config->saadc_us                = 20;
+  config->radio_overhead_ma       = 1.3;
+  config->radio_overhead_us       = 1100;
+  config->radio_rampup_ma         = 5.0;
+  config->radio_rampup_us         = 140;
+  config->radio_gap_us            = 200;
+  config->led_ma                  = 1.0;
+  config->bme_sleep_ua            = 0.2;
+  config->bme_t_ma                = 0.350;
+  config->bme_p_ma                = 0.714;
+  config->bme_h_ma                = 0.340;
+  config->lis_powerdown_ua        = 0.5;
+  config->pullup_kohm             = 13;
+
+  config->battery_mah             = 1000;
+  config->battery_derating        = 0.85;
+  config->battery_self_discharge_pct_year = 1;
+}
+
+bool energy_config_set(energy_config_t* config, const char* assignment)
+{
+  const char* separator = strchr(assignment, '=');
+  if(NULL == separator) { return false; }
+  size_t name_length = separator - assignment;
+  for(size_t ii = 0; ii < energy_parameters_count; ii++)
+  {
+    if(strlen(energy_parameters[ii].name) != name_length ||
+       strncmp(energy_parameters[ii].name, assignment, name_length)) { continue; }
+    char* end;
+    double value = strtod(separator + 1, &end);
+    if(end == separator + 1 || *end) { return false; }
+    *(double*)((char*)config + energy_parameters[ii].offset) = value;
+    return true;
+  }
+  return false;
+}
+
+typedef struct
+{
+  double x;
+  double y;
+} point_t;
+
+static double interpolate(const point_t* table, size_t count, double x)
+{
+  if(x <= table[0].x) { return table[0].y; }
+  for(size_t ii = 1; ii < count; ii++)
+  {
+    if(x <= table[ii].x)
+    {
+      double t = (x - table[ii - 1].x) / (table[ii].x - table[ii - 1].x);
+      return table[ii - 1].y + t * (table[ii].y - table[ii - 1].y);
+    }
+  }
+  return table[count - 1].y;
+}
+
+double energy_tx_current_ma(double tx_power_dbm)
+{
+  // nRF52832 product specification, I_TX with DC/DC enabled
+  static const point_t table[] = {
+    {-40, 2.7}, {-20, 3.2}, {-16, 3.3}, {-12, 3.5}, {-8, 3.8},
+    {-4,  4.2}, {0,   5.3}, {4,   7.5}
+  };
+  return interpolate(table, sizeof(table) / sizeof(table[0]), tx_power_dbm);
+}
+
+double energy_lis2dh12_current_ua(double rate_hz, double resolution_bits)
+{
+  // LIS2DH12 datasheet, current consumption in low-power and normal / high resolution modes
+  static const point_t low_power[] = {
+    {1, 2}, {10, 3}, {25, 4}, {50, 6}, {100, 10}, {200, 18}, {400, 36}
+  };
+  static const point_t normal[] = {
+    {1, 2}, {10, 4}, {25, 6}, {50, 11}, {100, 20}, {200, 38}, {400, 73}
+  };
+  if(rate_hz <= 0) { return 0; }
+  if(resolution_bits <= 8) { return interpolate(low_power, sizeof(low_power) / sizeof(low_power[0]), rate_hz); }
+  return interpolate(normal, sizeof(normal) / sizeof(normal[0]), rate_hz);
+}
+
+void energy_bme280_measurement(const energy_config_t* config, double* duration_us, double* charge_nc)
+{
+  // BME280 datasheet 9.1, typical measurement time in ms
+  double t_ms = 1 + 2 * config->bme_osrs_t;
+  double p_ms = config->bme_osrs_p ? 2 * config->bme_osrs_p + 0.5 : 0;
+  double h_ms = config->bme_osrs_h ? 2 * config->bme_osrs_h + 0.5 : 0;
+  *duration_us = (t_ms + p_ms + h_ms) * 1000;
+  *charge_nc   = (t_ms * config->bme_t_ma + p_ms * config->bme_p_ma + h_ms * config->bme_h_ma) * 1000;
+}
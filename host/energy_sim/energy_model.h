@@ -0,0 +1,129 @@
+/**
+ *  Configuration and current model of the energy simulator.
+ *
+ *  All values are doubles so that any of them can be overridden by name from
+ *  the command line. Defaults of the firmware configuration are taken from
+ *  application_config.h and bluetooth_application_config.h, defaults of the
+ *  current model are typical values from nRF52832, BME280, LIS2DH12 and CR2477
+ *  datasheets and should be calibrated against a power profiler when available.
+ */
+#ifndef ENERGY_MODEL_H
+#define ENERGY_MODEL_H
+
+#include <stddef.h>
+#include <stdbool.h>
+
+/** Consumers the simulated charge is accounted to */
+typedef enum
+{
+  ENERGY_SLEEP = 0,   /**< System ON sleep, RTC and RAM retention */
+  ENERGY_CPU,         /**< CPU running from flash, including wakeup */
+  ENERGY_SPI,         /**< SPIM transfers, CPU waiting */
+  ENERGY_SAADC,       /**< Battery measurement */
+  ENERGY_RADIO,       /**< Radio ramp-up and TX, softdevice pre/post processing */
+  ENERGY_LED,         /**< LEDs lit by main_sensor_task and sw_handler until sleep */
+  ENERGY_BME280,      /**< Environmental sensor conversions and standby */
+  ENERGY_LIS2DH12,    /**< Accelerometer sampling */
+  ENERGY_PULLUP,      /**< Current through reed switch pull-up while switch is closed */
+  ENERGY_CONSUMERS
+} energy_consumer_t;
+
+typedef struct
+{
+  /* Firmware configuration */
+  double main_interval_ms;     /**< MAIN_LOOP_INTERVAL_RAW */
+  double adv_interval_ms;      /**< ADVERTISING_INTERVAL_RAW */
+  double adv_startup_ms;       /**< ADVERTISING_STARTUP_PERIOD */
+  double adv_startup_interval_ms; /**< ADVERTISING_INTERVAL_STARTUP */
+  double adv_pdu_bytes;        /**< Bytes on air per advertisement channel, preamble to CRC */
+  double adv_channels;
+  double tx_power_dbm;         /**< BLE_TX_POWER */
+  double battery_interval_ms;  /**< APPLICATION_BATTERY_INTERVAL */
+  double bme_present;
+  double bme_standby_ms;       /**< BME280_DELAY */
+  double bme_forced;           /**< APPLICATION_BME280_FORCED_ENABLED, one conversion per main interval */
+  double bme_osrs_t;           /**< Oversampling as number of samples, 0 skips */
+  double bme_osrs_p;
+  double bme_osrs_h;
+  double lis_present;
+  double lis_rate_hz;          /**< Capture, knock or RAWv1 rate as configured */
+  double lis_resolution_bits;  /**< 8 is low power mode */
+  double switch_nc;            /**< 0: normally open (NO), 1: normally closed (NC) */
+
+  /* Environment */
+  double door_opens_per_day;
+  double door_open_s;          /**< Average time door stays open */
+  double acc_events_per_hour;  /**< LIS2DH12 INT2 activity interrupts */
+  double sim_days;
+  double seed;
+
+  /* Firmware cost model */
+  double task_cpu_us;          /**< main_sensor_task compute time excluding SPI */
+  double task_spi_transactions;
+  double task_spi_bytes;
+  double isr_cpu_us;           /**< Short interrupt handler incl. wakeup */
+  double sched_cpu_us;         /**< Scheduler dispatch of one event incl. wakeup */
+
+  /* Current model, mA unless noted */
+  double vdd_v;
+  double sleep_ua;             /**< System ON, RTC, full RAM retention */
+  double cpu_ma;
+  double spi_ma;               /**< SPIM and HFCLK while CPU sleeps in sd_app_evt_wait */
+  double spi_overhead_us;      /**< Per transaction setup and CS */
+  double spi_byte_us;          /**< 8 MHz SPI clock */
+  double saadc_ma;
+  double saadc_us;
+  double radio_overhead_ma;    /**< Softdevice pre/post processing, HFXO running */
+  double radio_overhead_us;
+  double radio_rampup_ma;
+  double radio_rampup_us;
+  double radio_gap_us;         /**< Channel switch gap, charged at radio_overhead_ma */
+  double led_ma;
+  double bme_sleep_ua;
+  double bme_t_ma;             /**< Current during temperature conversion */
+  double bme_p_ma;
+  double bme_h_ma;
+  double lis_powerdown_ua;
+  double pullup_kohm;
+
+  /* Battery */
+  double battery_mah;          /**< CR2477 nominal capacity */
+  double battery_derating;     /**< Usable fraction, pulse load and cold */
+  double battery_self_discharge_pct_year;
+} energy_config_t;
+
+/** Name and offset of a configuration value */
+typedef struct
+{
+  const char* name;
+  size_t      offset;
+} energy_parameter_t;
+
+extern const energy_parameter_t energy_parameters[];
+extern const size_t energy_parameters_count;
+
+/** Names of energy_consumer_t values for reports */
+extern const char* const energy_consumer_names[ENERGY_CONSUMERS];
+
+/** Fill configuration with firmware and model defaults */
+void energy_config_default(energy_config_t* config);
+
+/**
+ *  Set configuration value by name, "name=value".
+ *  @return true on success, false if name is unknown or value is not a number.
+ */
+bool energy_config_set(energy_config_t* config, const char* assignment);
+
+/** Radio TX current in mA at given power in dBm, DC/DC enabled */
+double energy_tx_current_ma(double tx_power_dbm);
+
+/** LIS2DH12 supply current in uA at given rate and resolution */
+double energy_lis2dh12_current_ua(double rate_hz, double resolution_bits);
+
+/**
+ *  BME280 measurement phases in microseconds and charge in nC for one
+ *  conversion with configured oversampling.
+ */
+void energy_bme280_measurement(const energy_config_t* config, double* duration_us, double* charge_nc);
+
+#endif
@@ -0,0 +1,372 @@
+/**
+ *  Discrete-event energy simulator of the door sensor firmware main loop.
+ *
+ *  Replays the wakeup sources of ruuvi_examples/ruuvi_firmware/main.c:
+ *   - main_timer_handler every MAIN_LOOP_INTERVAL_RAW, scheduling main_sensor_task
+ *   - advertising events with on_radio_evt notifications and battery measurement
+ *   - reed switch edges handled by sw_handler
+ *   - LIS2DH12 INT2 activity interrupts handled by lis2dh12_int2_handler
+ *  and charges each of them with the current model of energy_model.h.
+ *  Continuous consumers (sleep, sensors, reed switch pull-up) are integrated between events.
+ *
+ *  Usage: energy_sim [name=value ...] [vs name=value ...] ...
+ *  Each "vs" starts a new configuration from firmware defaults, results are printed
+ *  side by side. "energy_sim -h" lists parameters and defaults.
+ */
+#include <inttypes.h>
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "energy_model.h"
+
+#define MAX_CONFIGURATIONS 8
+#define US_PER_MS   1000ULL
+#define US_PER_S    1000000ULL
+#define HOURS_PER_YEAR 8760.0
+#define ADV_RANDOM_DELAY_MAX_US 10000  // advDelay of BLE specification
+
+/** Wakeup sources */
+typedef enum
+{
+  SOURCE_MAIN_TIMER = 0,
+  SOURCE_ADVERTISING,
+  SOURCE_BME280,
+  SOURCE_DOOR,
+  SOURCE_ACCELERATION,
+  SOURCES
+} source_t;
+
+static const char* const source_names[SOURCES] = {
+  [SOURCE_MAIN_TIMER]   = "main_sensor_task",
+  [SOURCE_ADVERTISING]  = "advertising",
+  [SOURCE_BME280]       = "bme280 conversion",
+  [SOURCE_DOOR]         = "reed switch edge",
+  [SOURCE_ACCELERATION] = "lis2dh12 int2"
+};
+
+typedef struct
+{
+  double   charge_nc[ENERGY_CONSUMERS];  /**< mA * us */
+  uint64_t events[SOURCES];
+  uint64_t battery_measurements;
+  uint64_t duration_us;
+  double   door_open_fraction;
+} energy_result_t;
+
+typedef struct
+{
+  const energy_config_t* config;
+  energy_result_t* result;
+  uint64_t now_us;
+  uint64_t next_us[SOURCES];
+  uint64_t last_battery_measurement_us;
+  uint64_t door_open_us;
+  bool     door_open;
+  uint64_t rng[SOURCES];  /**< One stream per source so configurations see the same environment */
+} simulation_t;
+
+/** xorshift64*, deterministic across platforms for given seed */
+static double random_uniform(simulation_t* sim, source_t source)
+{
+  uint64_t* state = &sim->rng[source];
+  *state ^= *state >> 12;
+  *state ^= *state << 25;
+  *state ^= *state >> 27;
+  return (double)((*state * 0x2545F4914F6CDD1DULL) >> 11) / (double)(1ULL << 53);
+}
+
+static uint64_t random_exponential_us(simulation_t* sim, source_t source, double mean_us)
+{
+  return (uint64_t)(-log(1.0 - random_uniform(sim, source)) * mean_us) + 1;
+}
+
+static void charge(simulation_t* sim, energy_consumer_t consumer, double current_ma, double duration_us)
+{
+  sim->result->charge_nc[consumer] += current_ma * duration_us;
+}
+
+/** Interrupt handler on GPIOTE, RTC or radio notification */
+static void charge_isr(simulation_t* sim)
+{
+  charge(sim, ENERGY_CPU, sim->config->cpu_ma, sim->config->isr_cpu_us);
+}
+
+static bool switch_conducting(const simulation_t* sim)
+{
+  // NO reed switch is closed next to magnet, i.e. while door is closed.
+  return sim->config->switch_nc ? sim->door_open : !sim->door_open;
+}
+
+/** Integrate consumers which are on between events */
+static void charge_continuous(simulation_t* sim, uint64_t duration_us)
+{
+  const energy_config_t* config = sim->config;
+  charge(sim, ENERGY_SLEEP, config->sleep_ua / 1000, duration_us);
+  if(config->lis_present)
+  {
+    double lis_ua = config->lis_rate_hz > 0 ?
+                    energy_lis2dh12_current_ua(config->lis_rate_hz, config->lis_resolution_bits) :
+                    config->lis_powerdown_ua;
+    charge(sim, ENERGY_LIS2DH12, lis_ua / 1000, duration_us);
+  }
+  if(config->bme_present)
+  {
+    charge(sim, ENERGY_BME280, config->bme_sleep_ua / 1000, duration_us);
+  }
+  if(switch_conducting(sim) && config->pullup_kohm > 0)
+  {
+    charge(sim, ENERGY_PULLUP, config->vdd_v / config->pullup_kohm, duration_us);
+  }
+  if(sim->door_open) { sim->door_open_us += duration_us; }
+}
+
+static double advertising_interval_us(const simulation_t* sim)
+{
+  const energy_config_t* config = sim->config;
+  double interval_ms = (sim->now_us < config->adv_startup_ms * US_PER_MS) ?
+                       config->adv_startup_interval_ms : config->adv_interval_ms;
+  return interval_ms * US_PER_MS;
+}
+
+/** main_timer_handler -> app_sched_event_put -> main_sensor_task */
+static void on_main_timer(simulation_t* sim)
+{
+  const energy_config_t* config = sim->config;
+  charge_isr(sim);
+  double cpu_us = config->sched_cpu_us + config->task_cpu_us;
+  double spi_us = 0;
+  if(config->bme_present || config->lis_present)
+  {
+    spi_us = config->task_spi_transactions * config->spi_overhead_us +
+             config->task_spi_bytes * config->spi_byte_us;
+  }
+  charge(sim, ENERGY_CPU, config->cpu_ma, cpu_us);
+  charge(sim, ENERGY_SPI, config->spi_ma, spi_us);
+  // LED is lit at start of the task and cleared in power_manage.
+  charge(sim, ENERGY_LED, config->led_ma, cpu_us + spi_us);
+  sim->next_us[SOURCE_MAIN_TIMER] += (uint64_t)(config->main_interval_ms * US_PER_MS);
+}
+
+/** Advertising event with radio notifications before and after */
+static void on_advertising(simulation_t* sim)
+{
+  const energy_config_t* config = sim->config;
+  double tx_us = config->adv_pdu_bytes * 8;  // 1 Mbps
+  charge_isr(sim);  // on_radio_evt(true)
+  charge(sim, ENERGY_RADIO, config->radio_overhead_ma, config->radio_overhead_us);
+  charge(sim, ENERGY_RADIO, config->radio_rampup_ma, config->adv_channels * config->radio_rampup_us);
+  charge(sim, ENERGY_RADIO, energy_tx_current_ma(config->tx_power_dbm), config->adv_channels * tx_us);
+  charge(sim, ENERGY_RADIO, config->radio_overhead_ma, (config->adv_channels - 1) * config->radio_gap_us);
+  charge_isr(sim);  // on_radio_evt(false)
+  if(sim->now_us - sim->last_battery_measurement_us > config->battery_interval_ms * US_PER_MS)
+  {
+    charge(sim, ENERGY_SAADC, config->saadc_ma, config->saadc_us);
+    charge(sim, ENERGY_CPU, config->cpu_ma, config->saadc_us);
+    sim->last_battery_measurement_us = sim->now_us;
+    sim->result->battery_measurements++;
+  }
+  sim->next_us[SOURCE_ADVERTISING] += (uint64_t)advertising_interval_us(sim) +
+                                      (uint64_t)(random_uniform(sim, SOURCE_ADVERTISING) * ADV_RANDOM_DELAY_MAX_US);
+}
+
+/** Normal mode conversion runs autonomously, forced mode conversion once per main loop */
+static void on_bme280(simulation_t* sim)
+{
+  double duration_us, charge_nc;
+  energy_bme280_measurement(sim->config, &duration_us, &charge_nc);
+  sim->result->charge_nc[ENERGY_BME280] += charge_nc;
+  if(sim->config->bme_forced) { sim->next_us[SOURCE_BME280] += (uint64_t)(sim->config->main_interval_ms * US_PER_MS); }
+  else { sim->next_us[SOURCE_BME280] += (uint64_t)(duration_us + sim->config->bme_standby_ms * US_PER_MS); }
+}
+
+/** in_pin_handler -> sw_handler in interrupt context */
+static void on_door(simulation_t* sim)
+{
+  const energy_config_t* config = sim->config;
+  charge_isr(sim);
+  // sw_handler lights a LED which is cleared in power_manage
+  charge(sim, ENERGY_LED, config->led_ma, config->isr_cpu_us);
+  sim->door_open = !sim->door_open;
+  if(sim->door_open)
+  {
+    sim->next_us[SOURCE_DOOR] += random_exponential_us(sim, SOURCE_DOOR, config->door_open_s * US_PER_S);
+  }
+  else
+  {
+    double mean_closed_s = 86400.0 / config->door_opens_per_day - config->door_open_s;
+    if(mean_closed_s < 1) { mean_closed_s = 1; }
+    sim->next_us[SOURCE_DOOR] += random_exponential_us(sim, SOURCE_DOOR, mean_closed_s * US_PER_S);
+  }
+}
+
+/** in_pin_handler -> lis2dh12_int2_handler in interrupt context */
+static void on_acceleration(simulation_t* sim)
+{
+  charge_isr(sim);
+  sim->next_us[SOURCE_ACCELERATION] += random_exponential_us(sim, SOURCE_ACCELERATION, 3600.0 * US_PER_S / sim->config->acc_events_per_hour);
+}
+
+static void simulate(const energy_config_t* config, energy_result_t* result)
+{
+  simulation_t sim = {
+    .config = config,
+    .result = result
+  };
+  for(source_t ii = 0; ii < SOURCES; ii++)
+  {
+    sim.rng[ii] = ((uint64_t)config->seed + 1) * 0x9E3779B97F4A7C15ULL + ii;
+  }
+  memset(result, 0, sizeof(*result));
+  result->duration_us = (uint64_t)(config->sim_days * 86400.0 * US_PER_S);
+
+  sim.next_us[SOURCE_MAIN_TIMER]   = (uint64_t)(config->main_interval_ms * US_PER_MS);
+  sim.next_us[SOURCE_ADVERTISING]  = 0;
+  sim.next_us[SOURCE_BME280]       = config->bme_present ? 0 : UINT64_MAX;
+  sim.next_us[SOURCE_DOOR]         = config->door_opens_per_day > 0 ?
+                                     random_exponential_us(&sim, SOURCE_DOOR, 86400.0 * US_PER_S / config->door_opens_per_day) : UINT64_MAX;
+  sim.next_us[SOURCE_ACCELERATION] = (config->lis_present && config->acc_events_per_hour > 0) ?
+                                     random_exponential_us(&sim, SOURCE_ACCELERATION, 3600.0 * US_PER_S / config->acc_events_per_hour) : UINT64_MAX;
+
+  while(true)
+  {
+    source_t source = SOURCE_MAIN_TIMER;
+    for(source_t ii = SOURCE_MAIN_TIMER; ii < SOURCES; ii++)
+    {
+      if(sim.next_us[ii] < sim.next_us[source]) { source = ii; }
+    }
+    uint64_t next_us = sim.next_us[source];
+    if(next_us >= result->duration_us)
+    {
+      charge_continuous(&sim, result->duration_us - sim.now_us);
+      break;
+    }
+    charge_continuous(&sim, next_us - sim.now_us);
+    sim.now_us = next_us;
+    result->events[source]++;
+
+    switch(source)
+    {
+      case SOURCE_MAIN_TIMER:   on_main_timer(&sim);   break;
+      case SOURCE_ADVERTISING:  on_advertising(&sim);  break;
+      case SOURCE_BME280:       on_bme280(&sim);       break;
+      case SOURCE_DOOR:         on_door(&sim);         break;
+      case SOURCE_ACCELERATION: on_acceleration(&sim); break;
+      default: break;
+    }
+  }
+  result->door_open_fraction = (double)sim.door_open_us / (double)result->duration_us;
+}
+
+static double average_ua(const energy_result_t* result, energy_consumer_t consumer)
+{
+  // nC / us = mA
+  return result->charge_nc[consumer] / (double)result->duration_us * 1000;
+}
+
+static double total_ua(const energy_result_t* result)
+{
+  double total = 0;
+  for(energy_consumer_t ii = 0; ii < ENERGY_CONSUMERS; ii++) { total += average_ua(result, ii); }
+  return total;
+}
+
+static double lifetime_hours(const energy_config_t* config, const energy_result_t* result)
+{
+  double capacity_uah = config->battery_mah * 1000;
+  double self_discharge_ua = capacity_uah * config->battery_self_discharge_pct_year / 100 / HOURS_PER_YEAR;
+  return capacity_uah * config->battery_derating / (total_ua(result) + self_discharge_ua);
+}
+
+static void print_usage(const char* name)
+{
+  energy_config_t config;
+  energy_config_default(&config);
+  printf("Usage: %s [name=value ...] [vs name=value ...]\n", name);
+  printf("Each \"vs\" starts a new configuration from defaults. Parameters and defaults:\n");
+  for(size_t ii = 0; ii < energy_parameters_count; ii++)
+  {
+    printf("  %-32s %g\n", energy_parameters[ii].name,
+           *(const double*)((const char*)&config + energy_parameters[ii].offset));
+  }
+}
+
+static void print_results(const energy_config_t* configs, const energy_result_t* results, size_t count)
+{
+  printf("%-24s", "");
+  for(size_t ii = 0; ii < count; ii++) { printf("       config %zu", ii); }
+  printf("\n");
+
+  printf("Average current, uA\n");
+  for(energy_consumer_t consumer = 0; consumer < ENERGY_CONSUMERS; consumer++)
+  {
+    printf("  %-22s", energy_consumer_names[consumer]);
+    for(size_t ii = 0; ii < count; ii++) { printf(" %14.3f", average_ua(&results[ii], consumer)); }
+    printf("\n");
+  }
+  printf("  %-22s", "total");
+  for(size_t ii = 0; ii < count; ii++) { printf(" %14.3f", total_ua(&results[ii])); }
+  printf("\n");
+
+  printf("Events\n");
+  for(source_t source = 0; source < SOURCES; source++)
+  {
+    printf("  %-22s", source_names[source]);
+    for(size_t ii = 0; ii < count; ii++) { printf(" %14" PRIu64, results[ii].events[source]); }
+    printf("\n");
+  }
+  printf("  %-22s", "battery measurement");
+  for(size_t ii = 0; ii < count; ii++) { printf(" %14" PRIu64, results[ii].battery_measurements); }
+  printf("\n");
+  printf("  %-22s", "door open, %");
+  for(size_t ii = 0; ii < count; ii++) { printf(" %14.2f", results[ii].door_open_fraction * 100); }
+  printf("\n");
+
+  printf("CR2477 lifetime\n");
+  printf("  %-22s", "days");
+  for(size_t ii = 0; ii < count; ii++) { printf(" %14.0f", lifetime_hours(&configs[ii], &results[ii]) / 24); }
+  printf("\n");
+  printf("  %-22s", "years");
+  for(size_t ii = 0; ii < count; ii++) { printf(" %14.2f", lifetime_hours(&configs[ii], &results[ii]) / HOURS_PER_YEAR); }
+  printf("\n");
+}
+
+int main(int argc, char** argv)
+{
+  static energy_config_t configs[MAX_CONFIGURATIONS];
+  static energy_result_t results[MAX_CONFIGURATIONS];
+  size_t count = 1;
+
+  energy_config_default(&configs[0]);
+  for(int ii = 1; ii < argc; ii++)
+  {
+    if(!strcmp(argv[ii], "-h") || !strcmp(argv[ii], "--help"))
+    {
+      print_usage(argv[0]);
+      return 0;
+    }
+    if(!strcmp(argv[ii], "vs"))
+    {
+      if(MAX_CONFIGURATIONS == count)
+      {
+        fprintf(stderr, "At most %d configurations\n", MAX_CONFIGURATIONS);
+        return 1;
+      }
+      energy_config_default(&configs[count++]);
+      continue;
+    }
+    if(!energy_config_set(&configs[count - 1], argv[ii]))
+    {
+      fprintf(stderr, "Invalid parameter \"%s\", see %s -h\n", argv[ii], argv[0]);
+      return 1;
+    }
+  }
+
+  for(size_t ii = 0; ii < count; ii++)
+  {
+    simulate(&configs[ii], &results[ii]);
+  }
+  print_results(configs, results, count);
+  return 0;
+}
@@ -0,0 +1,24 @@
+/**
+ *  Host shim for app_error.h. APP_ERROR_CHECK aborts on error like the
+ *  default error handler resets the tag.
+ */
+#ifndef HOST_APP_ERROR_H
+#define HOST_APP_ERROR_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "sdk_errors.h"
+
+#define APP_ERROR_CHECK(err_code)                                             \
+  do {                                                                        \
+    const uint32_t local_err_code = (err_code);                               \
+    if(NRF_SUCCESS != local_err_code)                                         \
+    {                                                                         \
+      fprintf(stderr, "APP_ERROR %u at %s:%d\n", (unsigned)local_err_code,    \
+              __FILE__, __LINE__);                                            \
+      abort();                                                                \
+    }                                                                         \
+  } while (0)
+
+#endif
@@ -0,0 +1,69 @@
+#include <stdlib.h>
+#include <string.h>
+#include "app_scheduler.h"
+#include "nrf_error.h"
+#include "trace.h"
+
+#define HOST_SCHED_QUEUE_MAX      64
+#define HOST_SCHED_EVENT_SIZE_MAX 64
+
+typedef struct
+{
+  app_sched_event_handler_t handler;
+  uint16_t event_size;
+  uint8_t  data[HOST_SCHED_EVENT_SIZE_MAX];
+} host_sched_event_t;
+
+static host_sched_event_t m_queue[HOST_SCHED_QUEUE_MAX];
+static uint16_t m_max_event_size = HOST_SCHED_EVENT_SIZE_MAX;
+static uint16_t m_queue_size = HOST_SCHED_QUEUE_MAX;
+static uint16_t m_start = 0;
+static uint16_t m_count = 0;
+
+uint32_t app_sched_init(uint16_t max_event_size, uint16_t queue_size, void* p_evt_buffer)
+{
+  (void)p_evt_buffer;
+  if(max_event_size > HOST_SCHED_EVENT_SIZE_MAX || queue_size > HOST_SCHED_QUEUE_MAX)
+  {
+    return NRF_ERROR_INVALID_PARAM;
+  }
+  m_max_event_size = max_event_size;
+  m_queue_size = queue_size;
+  m_start = 0;
+  m_count = 0;
+  return NRF_SUCCESS;
+}
+
+uint32_t app_sched_event_put(void const* p_event_data, uint16_t event_size, app_sched_event_handler_t handler)
+{
+  if(event_size > m_max_event_size || m_count >= m_queue_size)
+  {
+    TRACE_EVENT(TRACE_SCHED_PUT_FAILED, TRACE_ADDRESS(handler));
+    return (event_size > m_max_event_size) ? NRF_ERROR_INVALID_LENGTH : NRF_ERROR_NO_MEM;
+  }
+
+  host_sched_event_t* p_event = &m_queue[(m_start + m_count) % m_queue_size];
+  p_event->handler = handler;
+  p_event->event_size = event_size;
+  if(p_event_data && event_size) { memcpy(p_event->data, p_event_data, event_size); }
+  m_count++;
+  TRACE_EVENT(TRACE_SCHED_PUT, TRACE_ADDRESS(handler));
+  return NRF_SUCCESS;
+}
+
+void app_sched_execute(void)
+{
+  while(m_count)
+  {
+    host_sched_event_t event = m_queue[m_start];
+    m_start = (m_start + 1) % m_queue_size;
+    m_count--;
+    TRACE_EVENT(TRACE_SCHED_DISPATCH, TRACE_ADDRESS(event.handler));
+    event.handler(event.event_size ? event.data : NULL, event.event_size);
+  }
+}
+
+uint16_t app_sched_queue_space_get(void)
+{
+  return m_queue_size - m_count;
+}
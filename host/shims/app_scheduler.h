@@ -0,0 +1,27 @@
+/**
+ *  Host shim for app_scheduler.h.
+ *
+ *  Single-threaded FIFO with the same put/execute semantics as the SDK scheduler.
+ *  Event data is copied into the queue, so the caller may reuse its buffer.
+ */
+#ifndef HOST_APP_SCHEDULER_H
+#define HOST_APP_SCHEDULER_H
+
+#include <stdint.h>
+#include "sdk_errors.h"
+
+#define APP_SCHED_EVENT_HEADER_SIZE 8
+#define APP_SCHED_BUF_SIZE(EVENT_SIZE, QUEUE_SIZE) \
+  (((EVENT_SIZE) + APP_SCHED_EVENT_HEADER_SIZE) * ((QUEUE_SIZE) + 1))
+
+typedef void (*app_sched_event_handler_t)(void* p_event_data, uint16_t event_size);
+
+#define APP_SCHED_INIT(EVENT_SIZE, QUEUE_SIZE) \
+  APP_ERROR_CHECK(app_sched_init((EVENT_SIZE), (QUEUE_SIZE), NULL))
+
+uint32_t app_sched_init(uint16_t max_event_size, uint16_t queue_size, void* p_evt_buffer);
+uint32_t app_sched_event_put(void const* p_event_data, uint16_t event_size, app_sched_event_handler_t handler);
+void     app_sched_execute(void);
+uint16_t app_sched_queue_space_get(void);
+
+#endif
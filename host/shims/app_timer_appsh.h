@@ -0,0 +1,10 @@
+/**
+ *  Host shim for app_timer_appsh.h.
+ */
+#ifndef HOST_APP_TIMER_APPSH_H
+#define HOST_APP_TIMER_APPSH_H
+
+#include "app_timer.h"
+#include "app_scheduler.h"
+
+#endif
@@ -0,0 +1,16 @@
+/**
+ *  Host shim for boards.h. Pin assignments of RuuviTag B which host code refers to.
+ */
+#ifndef HOST_BOARDS_H
+#define HOST_BOARDS_H
+
+#define SPIM0_SS_ACC_PIN   8
+#define SPIM0_SS_HUMI_PIN  3
+#define INT_ACC1_PIN       2
+#define INT_ACC2_PIN       6
+#define BUTTON_1           13
+#define LED_RED            17
+#define LED_GREEN          19
+#define SW                 31
+
+#endif
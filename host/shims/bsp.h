@@ -0,0 +1,9 @@
+/**
+ *  Host shim for bsp.h. Included for declarations the host build does not use.
+ */
+#ifndef HOST_BSP_H
+#define HOST_BSP_H
+
+#include "nrf.h"
+
+#endif
@@ -0,0 +1,29 @@
+#include "host_clock.h"
+#include "rtc.h"
+
+static uint64_t m_now_us = 0;
+
+uint64_t host_clock_now_us(void)
+{
+  return m_now_us;
+}
+
+void host_clock_advance_us(uint64_t us)
+{
+  m_now_us += us;
+}
+
+void host_clock_reset(void)
+{
+  m_now_us = 0;
+}
+
+uint32_t init_rtc(void)
+{
+  return 0;
+}
+
+uint64_t millis(void)
+{
+  return m_now_us / 1000;
+}
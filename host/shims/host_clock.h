@@ -0,0 +1,17 @@
+/**
+ *  Simulated time of the host build.
+ *
+ *  Time stands still unless a program advances it. Device models use it to
+ *  decide how many samples have been produced and whether a conversion is
+ *  still running, nrf_delay_ms advances it.
+ */
+#ifndef HOST_CLOCK_H
+#define HOST_CLOCK_H
+
+#include <stdint.h>
+
+uint64_t host_clock_now_us(void);
+void     host_clock_advance_us(uint64_t us);
+void     host_clock_reset(void);
+
+#endif
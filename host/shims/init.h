@@ -0,0 +1,18 @@
+/**
+ *  Host shim for drivers/init/init.h. Only the timer configuration is used by libraries and drivers.
+ */
+#ifndef HOST_INIT_H
+#define HOST_INIT_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "app_scheduler.h"
+#include "app_timer_appsh.h"
+#include "ruuvi_endpoints.h"
+
+#define RUUVITAG_APP_TIMER_PRESCALER     15
+#define RUUVITAG_APP_TIMER_OP_QUEUE_SIZE 16
+#define APP_TIMER_PRESCALER              RUUVITAG_APP_TIMER_PRESCALER
+#define APP_TIMER_OP_QUEUE_SIZE          RUUVITAG_APP_TIMER_OP_QUEUE_SIZE
+
+#endif
@@ -0,0 +1,17 @@
+/**
+ *  Host shim for nordic_common.h.
+ */
+#ifndef HOST_NORDIC_COMMON_H
+#define HOST_NORDIC_COMMON_H
+
+#ifndef MAX
+  #define MAX(a, b) ((a) < (b) ? (b) : (a))
+#endif
+#ifndef MIN
+  #define MIN(a, b) ((a) < (b) ? (a) : (b))
+#endif
+
+#define UNUSED_PARAMETER(X) ((void)(X))
+#define UNUSED_VARIABLE(X)  ((void)(X))
+
+#endif
@@ -0,0 +1,8 @@
+#include "nrf.h"
+
+/** Arbitrary but stable device identity, E6:2A:... style random static address */
+host_ficr_t host_ficr = {
+  .DEVICEID       = {0x8C3E5B21, 0x1F7A90D4},
+  .DEVICEADDRTYPE = 1,
+  .DEVICEADDR     = {0x2A9F4C11, 0x0000E62B}
+};
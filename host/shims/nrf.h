@@ -0,0 +1,51 @@
+/**
+ *  Host shim for nrf.h.
+ *
+ *  Provides the factory information registers used by the sensor formats. The
+ *  contents of host_ficr can be changed at runtime to emulate a different device.
+ */
+#ifndef HOST_NRF_H
+#define HOST_NRF_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+typedef struct
+{
+  uint32_t DEVICEID[2];
+  uint32_t DEVICEADDRTYPE;
+  uint32_t DEVICEADDR[2];
+} host_ficr_t;
+
+extern host_ficr_t host_ficr;
+
+#define NRF_FICR (&host_ficr)
+
+/**
+ *  CMSIS SIMD intrinsics of Cortex-M4 as the instructions define them. Only used when
+ *  __ARM_FEATURE_DSP is defined, i.e. libraries/dsp kernels built for dsp_check.
+ *  Q flag is not modelled, results wrap like on device.
+ */
+#ifdef __ARM_FEATURE_DSP
+static inline uint32_t __SMLAD(uint32_t x, uint32_t y, uint32_t acc)
+{
+  int64_t sum = (int64_t)(int16_t)x * (int16_t)y + (int64_t)(int16_t)(x >> 16) * (int16_t)(y >> 16);
+  return (uint32_t)(sum + acc);
+}
+
+static inline uint32_t __SMUAD(uint32_t x, uint32_t y)
+{
+  return __SMLAD(x, y, 0);
+}
+
+static inline int32_t __SSAT(int32_t x, uint32_t bits)
+{
+  const int32_t max = (1 << (bits - 1)) - 1;
+  if(x > max)      { return max; }
+  if(x < -max - 1) { return -max - 1; }
+  return x;
+}
+#endif
+
+#endif
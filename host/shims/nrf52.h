@@ -0,0 +1,9 @@
+/**
+ *  Host shim for nrf52.h. Register definitions live in nrf.h.
+ */
+#ifndef HOST_NRF52_H
+#define HOST_NRF52_H
+
+#include "nrf.h"
+
+#endif
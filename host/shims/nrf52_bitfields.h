@@ -0,0 +1,9 @@
+/**
+ *  Host shim for nrf52_bitfields.h. Register definitions live in nrf.h.
+ */
+#ifndef HOST_NRF52_BITFIELDS_H
+#define HOST_NRF52_BITFIELDS_H
+
+#include "nrf.h"
+
+#endif
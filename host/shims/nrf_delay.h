@@ -0,0 +1,13 @@
+/**
+ *  Host shim for nrf_delay.h. Delays advance simulated time instead of waiting.
+ */
+#ifndef HOST_NRF_DELAY_H
+#define HOST_NRF_DELAY_H
+
+#include <stdint.h>
+#include "host_clock.h"
+
+static inline void nrf_delay_ms(uint32_t ms) { host_clock_advance_us((uint64_t)ms * 1000); }
+static inline void nrf_delay_us(uint32_t us) { host_clock_advance_us(us); }
+
+#endif
@@ -0,0 +1,9 @@
+/**
+ *  Host shim for nrf_drv_gpiote.h. Included for declarations the host build does not use.
+ */
+#ifndef HOST_NRF_DRV_GPIOTE_H
+#define HOST_NRF_DRV_GPIOTE_H
+
+#include "nrf.h"
+
+#endif
@@ -0,0 +1,9 @@
+/**
+ *  Host shim for nrf_drv_timer.h. Included for declarations the host build does not use.
+ */
+#ifndef HOST_NRF_DRV_TIMER_H
+#define HOST_NRF_DRV_TIMER_H
+
+#include "nrf.h"
+
+#endif
@@ -0,0 +1,62 @@
+/**
+ *  Host shim for nrf_log.h.
+ *
+ *  Log calls compile to nothing unless HOST_LOG_ENABLED is defined, in which case
+ *  they are printed to stderr. Arguments are always type-checked so that variables
+ *  used only in logs do not trigger unused warnings.
+ */
+#ifndef HOST_NRF_LOG_H
+#define HOST_NRF_LOG_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdarg.h>
+
+#ifndef NRF_LOG_MODULE_NAME
+  #define NRF_LOG_MODULE_NAME "HOST"
+#endif
+
+static inline void host_log_sink(const char* format, ...)
+{
+#ifdef HOST_LOG_ENABLED
+  va_list args;
+  va_start(args, format);
+  vfprintf(stderr, format, args);
+  va_end(args);
+#else
+  (void)format;
+#endif
+}
+
+static inline void host_log_hexdump(const void* data, size_t length)
+{
+#ifdef HOST_LOG_ENABLED
+  const uint8_t* p_data = data;
+  for(size_t ii = 0; ii < length; ii++) { fprintf(stderr, "%02X ", p_data[ii]); }
+#else
+  (void)data;
+  (void)length;
+#endif
+}
+
+#ifdef HOST_LOG_ENABLED
+  #define HOST_LOG_ACTIVE 1
+#else
+  #define HOST_LOG_ACTIVE 0
+#endif
+
+#define NRF_LOG_ERROR(...)   if(HOST_LOG_ACTIVE) { host_log_sink(__VA_ARGS__); }
+#define NRF_LOG_WARNING(...) if(HOST_LOG_ACTIVE) { host_log_sink(__VA_ARGS__); }
+#define NRF_LOG_INFO(...)    if(HOST_LOG_ACTIVE) { host_log_sink(__VA_ARGS__); }
+#define NRF_LOG_DEBUG(...)   if(HOST_LOG_ACTIVE) { host_log_sink(__VA_ARGS__); }
+
+#define NRF_LOG_HEXDUMP_ERROR(p_data, len)   if(HOST_LOG_ACTIVE) { host_log_hexdump((p_data), (len)); }
+#define NRF_LOG_HEXDUMP_WARNING(p_data, len) if(HOST_LOG_ACTIVE) { host_log_hexdump((p_data), (len)); }
+#define NRF_LOG_HEXDUMP_INFO(p_data, len)    if(HOST_LOG_ACTIVE) { host_log_hexdump((p_data), (len)); }
+#define NRF_LOG_HEXDUMP_DEBUG(p_data, len)   if(HOST_LOG_ACTIVE) { host_log_hexdump((p_data), (len)); }
+
+#define NRF_LOG_INIT(timestamp_func) NRF_SUCCESS
+#define NRF_LOG_FLUSH()
+#define NRF_LOG_PROCESS() false
+
+#endif
@@ -0,0 +1,9 @@
+/**
+ *  Host shim for nrf_log_ctrl.h. Everything lives in nrf_log.h.
+ */
+#ifndef HOST_NRF_LOG_CTRL_H
+#define HOST_NRF_LOG_CTRL_H
+
+#include "nrf_log.h"
+
+#endif
@@ -0,0 +1,13 @@
+/**
+ *  Host shim for drivers/rtc/rtc.h, millis() follows host_clock.h.
+ */
+#ifndef RTC_H
+#define RTC_H
+
+#include <stdint.h>
+
+uint32_t init_rtc(void);
+
+uint64_t millis(void);
+
+#endif
@@ -0,0 +1,13 @@
+/**
+ *  Host shim for sdk_common.h.
+ */
+#ifndef HOST_SDK_COMMON_H
+#define HOST_SDK_COMMON_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include "nordic_common.h"
+#include "sdk_errors.h"
+
+#endif
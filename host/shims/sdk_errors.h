@@ -0,0 +1,12 @@
+/**
+ *  Host shim for sdk_errors.h.
+ */
+#ifndef HOST_SDK_ERRORS_H
+#define HOST_SDK_ERRORS_H
+
+#include <stdint.h>
+#include "nrf_error.h"
+
+typedef uint32_t ret_code_t;
+
+#endif
@@ -0,0 +1,173 @@
+/**
+ *  SPI bus traffic of the sensor drivers.
+ *
+ *  Runs the sensor initialisation of ruuvi_examples/ruuvi_firmware/main.c and
+ *  the sensor reads of main_sensor_task against the device models in devices/
+ *  and reports SPI transactions and bytes per device for each phase.
+ *
+ *  Usage: spi_traffic [tasks] [trace]
+ *  Runs given number of main loop tasks, default 10, and prints per task averages
+ *  and the profiler probes hit by the sensor reads. Tasks go through the scheduler
+ *  like in main.c; if trace is given, the event trace of the tasks is written to
+ *  that file for host/trace_decode.
+ */
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "app_scheduler.h"
+#include "application_config.h"
+#include "bluetooth_application_config.h"
+#include "bme280.h"
+#include "lis2dh12.h"
+#include "host_clock.h"
+#include "nrf_delay.h"
+#include "spi_host.h"
+#include "lis2dh12_model.h"
+#include "bme280_model.h"
+#include "profiler.h"
+#include "trace.h"
+
+#define DEFAULT_TASKS 10
+
+static const char* const m_device_names[SPI_HOST_DEVICES] = {"BME280", "LIS2DH12"};
+static const char* const m_probe_names[PROFILER_PROBES] = {
+  "main_sensor_task",
+  "bme280_read_measurements",
+  "lis2dh12_read_samples",
+  "encodeToSWRawFormat5",
+  "bluetooth_set_manufacturer_data",
+  "ble_advdata_set"
+};
+
+static void print_stats(const char* phase, uint32_t divisor)
+{
+  for(int device = 0; device < SPI_HOST_DEVICES; device++)
+  {
+    spi_host_stats_t stats = spi_host_stats_get(device);
+    printf("%-14s %-9s %10.1f %10.1f\n", phase, m_device_names[device],
+           (double)stats.transactions / divisor, (double)stats.bytes / divisor);
+  }
+}
+
+/** Sensor part of init_sensors() in drivers/init/init.c and main() */
+static void print_profile(void)
+{
+  printf("\n%-32s %8s %10s %10s %10s\n", "probe", "count", "min", "max", "mean");
+  for(profiler_probe_t probe = 0; probe < PROFILER_PROBES; probe++)
+  {
+    const profiler_stats_t* stats = profiler_stats_get(probe);
+    if(0 == stats->count) { continue; }
+    printf("%-32s %8"PRIu32" %10"PRIu32" %10"PRIu32" %10"PRIu64"\n", m_probe_names[probe],
+           stats->count, stats->min, stats->max, stats->total / stats->count);
+  }
+  printf("Cycles at %u Hz, host clock scaled to target core clock\n", PROFILER_CORE_CLOCK_HZ);
+}
+
+static void sensor_init(void)
+{
+  lis2dh12_init();
+  bme280_init();
+  const bme280_config_t init_config = {
+    .os_hum   = BME280_OVERSAMPLING_1,
+    .os_temp  = BME280_OVERSAMPLING_1,
+    .os_press = BME280_OVERSAMPLING_1,
+    .iir      = BME280_IIR_OFF,
+    .interval = BME280_STANDBY_1000_MS,
+    .mode     = BME280_MODE_SLEEP
+  };
+  bme280_configure(&init_config);
+
+  lis2dh12_reset();
+  nrf_delay_ms(10);
+  lis2dh12_enable();
+  lis2dh12_set_scale(LIS2DH12_SCALE);
+  lis2dh12_set_sample_rate(LIS2DH12_SAMPLERATE_RAWv1);
+  lis2dh12_set_resolution(LIS2DH12_RESOLUTION);
+  lis2dh12_set_activity_interrupt_pin_2(LIS2DH12_ACTIVITY_THRESHOLD);
+
+  bme280_config_t config = {
+    .os_hum   = BME280_HUMIDITY_OVERSAMPLING,
+    .os_temp  = BME280_TEMPERATURE_OVERSAMPLING,
+    .os_press = BME280_PRESSURE_OVERSAMPLING,
+    .interval = BME280_DELAY
+  };
+#if APPLICATION_BME280_FORCED_ENABLED
+  config.iir  = BME280_IIR_OFF;
+  config.mode = BME280_MODE_FORCED;
+  bme280_set_software_iir(BME280_SOFTWARE_IIR);
+#else
+  config.iir  = BME280_IIR;
+  config.mode = BME280_MODE_NORMAL;
+#endif
+  bme280_configure(&config);
+}
+
+static lis2dh12_sensor_buffer_t m_buffer;
+static bme280_data_t m_environment;
+
+/** Sensor reads of main_sensor_task() */
+static void sensor_task(void* p_data, uint16_t length)
+{
+#if APPLICATION_BME280_FORCED_ENABLED
+  // bme280_trigger_task and timeout of the conversion time
+  bme280_set_mode(BME280_MODE_FORCED);
+  host_clock_advance_us(bme280_measurement_time_us());
+  if(!bme280_is_measuring()) { bme280_read_measurements(); }
+#else
+  bme280_read_measurements();
+#endif
+  m_environment.temperature = bme280_get_temperature();
+  m_environment.pressure    = bme280_get_pressure();
+  m_environment.humidity    = bme280_get_humidity();
+  lis2dh12_read_samples(&m_buffer, 1);
+}
+
+static int write_trace(const char* path)
+{
+  static uint8_t dump[TRACE_SERIALIZED_LENGTH];
+  size_t length = trace_serialize(dump, sizeof(dump));
+  FILE* file = fopen(path, "wb");
+  if(NULL == file) { perror(path); return 1; }
+  fwrite(dump, 1, length, file);
+  fclose(file);
+  printf("\nTrace of %"PRIu32" events written to %s\n", trace_count(), path);
+  return 0;
+}
+
+int main(int argc, char** argv)
+{
+  uint32_t tasks = DEFAULT_TASKS;
+  if(argc > 1) { tasks = strtoul(argv[1], NULL, 0); }
+  if(0 == tasks)
+  {
+    fprintf(stderr, "Usage: %s [tasks] [trace]\n", argv[0]);
+    return 1;
+  }
+
+  host_clock_reset();
+  spi_host_reset();
+  printf("%-14s %-9s %10s %10s\n", "phase", "device", "transfers", "bytes");
+  sensor_init();
+  print_stats("init", 1);
+
+  spi_host_stats_reset();
+  profiler_init();
+  trace_reset();
+  for(uint32_t ii = 0; ii < tasks; ii++)
+  {
+    host_clock_advance_us(MAIN_LOOP_INTERVAL_RAW * 1000ULL);
+    lis2dh12_model_update();
+    app_sched_event_put(NULL, 0, sensor_task);
+    app_sched_execute();
+  }
+  print_stats("sensor task", tasks);
+
+  printf("\nLast task: %"PRId32".%02"PRId32" C, %"PRIu32" Pa, %"PRIu32" %%RH, acceleration %d, %d, %d mg\n",
+         m_environment.temperature / 100, abs(m_environment.temperature % 100),
+         m_environment.pressure >> 8, m_environment.humidity >> 10,
+         m_buffer.sensor.x, m_buffer.sensor.y, m_buffer.sensor.z);
+  printf("BME280 conversions: %"PRIu32"\n", bme280_model_conversions());
+  print_profile();
+  if(argc > 2) { return write_trace(argv[2]); }
+  return 0;
+}
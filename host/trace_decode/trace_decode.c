@@ -0,0 +1,290 @@
+/**
+ *  Decoder of event trace dumps, see libraries/trace/trace.h.
+ *
+ *  Prints the events of a trace_serialize() dump as a timeline with time since
+ *  previous event and, for scheduler dispatches, the time the event waited in
+ *  the scheduler queue. Ends with event counts, queueing delays and the
+ *  busiest one second window to spot wakeup storms.
+ *
+ *  Usage: trace_decode [-x] [-s symbols] dump
+ *    -x          dump is hex text, e.g. copied from a BLE terminal, instead of binary
+ *    -s symbols  "nm" output of the firmware ELF, names scheduler handlers
+ *  Dump "-" reads stdin.
+ */
+#include <ctype.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "trace.h"
+#include "boards.h"
+
+#define DUMP_MAX_LENGTH  (TRACE_HEADER_LENGTH + 65536 * TRACE_RECORD_LENGTH)
+#define SYMBOLS_MAX      4096
+#define SYMBOL_NAME_MAX  64
+#define PENDING_MAX      64
+#define WINDOW_MS        1000
+
+typedef struct
+{
+  uint32_t address;
+  char     name[SYMBOL_NAME_MAX];
+} symbol_t;
+
+typedef struct
+{
+  uint16_t handler;
+  uint32_t time;
+} pending_t;
+
+static const char* const m_event_names[TRACE_EVENTS] = {
+  [TRACE_SCHED_PUT]        = "sched put",
+  [TRACE_SCHED_PUT_FAILED] = "sched put FAILED",
+  [TRACE_SCHED_DISPATCH]   = "sched dispatch",
+  [TRACE_PIN]              = "pin",
+  [TRACE_RADIO]            = "radio",
+  [TRACE_SPI_START]        = "spi start",
+  [TRACE_SPI_STOP]         = "spi stop",
+};
+
+static symbol_t m_symbols[SYMBOLS_MAX];
+static size_t   m_symbol_count = 0;
+static pending_t m_pending[PENDING_MAX];
+static size_t    m_pending_count = 0;
+
+static uint32_t get_uint32(const uint8_t* p)
+{
+  return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static uint16_t get_uint16(const uint8_t* p)
+{
+  return p[0] | (p[1] << 8);
+}
+
+/** Reads "address type name" lines of nm output, text symbols only */
+static int symbols_load(const char* path)
+{
+  FILE* file = fopen(path, "r");
+  if(NULL == file) { perror(path); return -1; }
+  char line[256];
+  while(fgets(line, sizeof(line), file) && m_symbol_count < SYMBOLS_MAX)
+  {
+    unsigned long address;
+    char type;
+    char name[SYMBOL_NAME_MAX];
+    if(3 != sscanf(line, "%lx %c %63s", &address, &type, name)) { continue; }
+    if('t' != tolower((unsigned char)type)) { continue; }
+    m_symbols[m_symbol_count].address = address & ~1UL;  // Clear thumb bit
+    strcpy(m_symbols[m_symbol_count].name, name);
+    m_symbol_count++;
+  }
+  fclose(file);
+  return 0;
+}
+
+/** Returns name of the function at traced address, NULL if unknown */
+static const char* symbol_name(uint16_t handler)
+{
+  const char* name = NULL;
+  for(size_t ii = 0; ii < m_symbol_count; ii++)
+  {
+    if(TRACE_ADDRESS(m_symbols[ii].address) != handler) { continue; }
+    // Several functions may share the traced address, list is ambiguous then.
+    if(name) { return "(ambiguous)"; }
+    name = m_symbols[ii].name;
+  }
+  return name;
+}
+
+static void print_handler(uint16_t handler)
+{
+  const char* name = symbol_name(handler);
+  if(name) { printf("%s", name); }
+  else     { printf("0x%05x", (uint32_t)handler << TRACE_ADDRESS_SHIFT); }
+}
+
+static const char* spi_device(uint8_t pin)
+{
+  switch(pin)
+  {
+    case SPIM0_SS_HUMI_PIN: return "BME280";
+    case SPIM0_SS_ACC_PIN:  return "LIS2DH12";
+    default:                return "?";
+  }
+}
+
+static void pending_push(uint16_t handler, uint32_t time)
+{
+  if(PENDING_MAX == m_pending_count)
+  {
+    memmove(m_pending, m_pending + 1, sizeof(m_pending) - sizeof(m_pending[0]));
+    m_pending_count--;
+  }
+  m_pending[m_pending_count].handler = handler;
+  m_pending[m_pending_count].time = time;
+  m_pending_count++;
+}
+
+/** Removes oldest put of handler, returns 0 if it was not in the trace */
+static int pending_pop(uint16_t handler, uint32_t* time)
+{
+  for(size_t ii = 0; ii < m_pending_count; ii++)
+  {
+    if(m_pending[ii].handler != handler) { continue; }
+    *time = m_pending[ii].time;
+    memmove(&m_pending[ii], &m_pending[ii + 1], (m_pending_count - ii - 1) * sizeof(m_pending[0]));
+    m_pending_count--;
+    return 1;
+  }
+  return 0;
+}
+
+static size_t read_dump(FILE* file, uint8_t* buffer, size_t length, int hex)
+{
+  if(!hex) { return fread(buffer, 1, length, file); }
+  size_t count = 0;
+  int high = -1;
+  int c;
+  while(count < length && EOF != (c = fgetc(file)))
+  {
+    if(!isxdigit(c)) { continue; }
+    int nibble = isdigit(c) ? c - '0' : tolower(c) - 'a' + 10;
+    if(high < 0) { high = nibble; continue; }
+    buffer[count++] = (high << 4) | nibble;
+    high = -1;
+  }
+  return count;
+}
+
+static void usage(const char* name)
+{
+  fprintf(stderr, "Usage: %s [-x] [-s symbols] dump\n", name);
+}
+
+int main(int argc, char** argv)
+{
+  int hex = 0;
+  int opt;
+  while(-1 != (opt = getopt(argc, argv, "xs:")))
+  {
+    switch(opt)
+    {
+      case 'x': hex = 1; break;
+      case 's': if(symbols_load(optarg)) { return 1; } break;
+      default:  usage(argv[0]); return 1;
+    }
+  }
+  if(optind >= argc) { usage(argv[0]); return 1; }
+
+  FILE* file = strcmp(argv[optind], "-") ? fopen(argv[optind], hex ? "r" : "rb") : stdin;
+  if(NULL == file) { perror(argv[optind]); return 1; }
+  uint8_t* dump = malloc(DUMP_MAX_LENGTH);
+  if(NULL == dump) { return 1; }
+  size_t length = read_dump(file, dump, DUMP_MAX_LENGTH, hex);
+  if(stdin != file) { fclose(file); }
+
+  if(length < TRACE_HEADER_LENGTH || TRACE_FORMAT_VERSION != dump[0] || TRACE_RECORD_LENGTH != dump[1])
+  {
+    fprintf(stderr, "Not a trace dump of version %d\n", TRACE_FORMAT_VERSION);
+    free(dump);
+    return 1;
+  }
+  uint32_t count = get_uint16(dump + 2);
+  uint32_t total = get_uint32(dump + 4);
+  if(length < TRACE_HEADER_LENGTH + count * TRACE_RECORD_LENGTH)
+  {
+    fprintf(stderr, "Dump truncated, %u of %u records\n",
+            (unsigned)((length - TRACE_HEADER_LENGTH) / TRACE_RECORD_LENGTH), (unsigned)count);
+    count = (length - TRACE_HEADER_LENGTH) / TRACE_RECORD_LENGTH;
+  }
+  printf("%"PRIu32" events, %"PRIu32" recorded since reset, %"PRIu32" overwritten\n\n",
+         count, total, total - count);
+  printf("%10s %8s  %-17s %s\n", "time ms", "delta", "event", "argument");
+
+  uint32_t event_counts[TRACE_EVENTS] = {0};
+  uint32_t waits = 0, wait_total = 0, wait_max = 0;
+  uint32_t window_max = 0, window_start = 0;
+  const uint8_t* records = dump + TRACE_HEADER_LENGTH;
+  for(uint32_t ii = 0; ii < count; ii++)
+  {
+    const uint8_t* record = records + ii * TRACE_RECORD_LENGTH;
+    uint32_t time  = get_uint32(record);
+    uint8_t  event = record[4];
+    uint16_t arg   = get_uint16(record + 5);
+    uint32_t delta = ii ? time - get_uint32(record - TRACE_RECORD_LENGTH) : 0;
+
+    // Events in the WINDOW_MS ending at this one
+    uint32_t first = ii;
+    while(first > 0 && time - get_uint32(records + (first - 1) * TRACE_RECORD_LENGTH) < WINDOW_MS) { first--; }
+    if(ii - first + 1 > window_max)
+    {
+      window_max = ii - first + 1;
+      window_start = get_uint32(records + first * TRACE_RECORD_LENGTH);
+    }
+
+    if(event >= TRACE_EVENTS || NULL == m_event_names[event])
+    {
+      printf("%10"PRIu32" %+8"PRId32"  unknown event %u, arg 0x%04x\n", time, (int32_t)delta, event, arg);
+      continue;
+    }
+    event_counts[event]++;
+    printf("%10"PRIu32" %+8"PRId32"  %-17s ", time, (int32_t)delta, m_event_names[event]);
+    switch(event)
+    {
+      case TRACE_SCHED_PUT:
+        pending_push(arg, time);
+        print_handler(arg);
+        break;
+
+      case TRACE_SCHED_PUT_FAILED:
+        print_handler(arg);
+        break;
+
+      case TRACE_SCHED_DISPATCH:
+      {
+        uint32_t put_time;
+        print_handler(arg);
+        if(pending_pop(arg, &put_time))
+        {
+          uint32_t wait = time - put_time;
+          printf(", waited %"PRIu32" ms", wait);
+          waits++;
+          wait_total += wait;
+          if(wait > wait_max) { wait_max = wait; }
+        }
+        break;
+      }
+
+      case TRACE_PIN:
+        printf("%u %s", arg & 0xFF, (arg >> 8) ? "high" : "low");
+        break;
+
+      case TRACE_RADIO:
+        printf("%s", arg ? "active" : "off");
+        break;
+
+      case TRACE_SPI_START:
+      case TRACE_SPI_STOP:
+        printf("%s, %u bytes", spi_device(arg >> 8), arg & 0xFF);
+        break;
+    }
+    printf("\n");
+  }
+
+  printf("\n%-17s %8s\n", "event", "count");
+  for(size_t ii = 0; ii < TRACE_EVENTS; ii++)
+  {
+    if(NULL == m_event_names[ii]) { continue; }
+    printf("%-17s %8"PRIu32"\n", m_event_names[ii], event_counts[ii]);
+  }
+  if(waits)
+  {
+    printf("\nScheduler queueing delay: mean %.1f ms, max %"PRIu32" ms over %"PRIu32" dispatches\n",
+           (double)wait_total / waits, wait_max, waits);
+  }
+  printf("Busiest %d ms window: %"PRIu32" events from %"PRIu32" ms\n", WINDOW_MS, window_max, window_start);
+  free(dump);
+  return 0;
+}
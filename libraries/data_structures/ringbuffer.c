@@ -12,14 +12,35 @@
 
 // Based on https://jlmedina123.wordpress.com/2013/08/19/circular-buffer-queue/
 
-void ringbuffer_init(ringbuffer_t *buffer, size_t  element_max, size_t element_size)
+// Smallest power of two >= n
+static size_t round_up_to_power_of_two(size_t n)
 {
+  size_t power = 1;
+  while(power < n) { power <<= 1; }
+  return power;
+}
+
+int ringbuffer_init(ringbuffer_t *buffer, size_t  element_max, size_t element_size)
+{
+    element_max = round_up_to_power_of_two(element_max);
     buffer->element_max = element_max;
     buffer->element_size = element_size;
     buffer->start = 0;
     buffer->count = 0;
     buffer->element = malloc(element_size * element_max);
     NRF_LOG_INFO("Init ringbuffer, size of one element is %d\r\n", buffer->element_size);
+    return (NULL != buffer->element);
+}
+
+int ringbuffer_init_static(ringbuffer_t *buffer, void* storage, size_t element_max, size_t element_size)
+{
+  if(NULL == storage || 0 == element_max || (element_max & (element_max - 1))) { return 0; }
+  buffer->element_max = element_max;
+  buffer->element_size = element_size;
+  buffer->start = 0;
+  buffer->count = 0;
+  buffer->element = storage;
+  return 1;
 }
 
 void ringbuffer_uninit(ringbuffer_t *buffer)
@@ -46,27 +67,21 @@ int ringbuffer_is_init(ringbuffer_t *buffer)
 void ringbuffer_peek_at(ringbuffer_t* buffer, size_t index, void* element)
 {
   //Calculate element position at X, relative to ringbuffer start
-  size_t position = (buffer->start)+index;
-  if(position >= buffer->element_max) { position = position - buffer->element_max; }
+  size_t position = (buffer->start + index) & (buffer->element_max - 1);
   NRF_LOG_DEBUG("Copying %d bytes to %d\r\n", buffer->element_size, (uint32_t)((buffer->element) + (position * buffer->element_size)));
   memcpy(element, (buffer->element) + (position * buffer->element_size), buffer->element_size);
 }
 
-//TODO: #define overflow behaviour.
+// Full buffer overwrites oldest element
 void ringbuffer_push(ringbuffer_t* buffer, void* data)
 {
-  int index;
-  index = buffer->start + buffer->count++;
-  //Wraparound
-  if (index >= buffer->element_max) 
-  {
-    index = index-(buffer->element_max);
-  }
+  size_t mask = buffer->element_max - 1;
+  size_t index = (buffer->start + buffer->count) & mask;
   void* target = buffer->element + (index * buffer->element_size);
   NRF_LOG_DEBUG("Buffer starts at %d, pushing %d bytes to address %d\r\n", (uint32_t)buffer->element, (uint32_t)buffer->element_size, (uint32_t)target);
   memcpy(target, data, buffer->element_size);
-  //Buffer overflow? pop element (this is actually newest element / same as input due to overflow
-  if(buffer->count > buffer->element_max){ ringbuffer_popqueue(buffer, data); }
+  if(buffer->count == buffer->element_max) { buffer->start = (buffer->start + 1) & mask; }
+  else { buffer->count++; }
 }
  
  
@@ -77,27 +92,18 @@ void ringbuffer_popqueue(ringbuffer_t* buffer, void* element)
   /* FIFO implementation */
   void* source = buffer->element + ((buffer->start) * (buffer->element_size));
   memcpy(element, source, buffer->element_size);
-  buffer->start++;
+  buffer->start = (buffer->start + 1) & (buffer->element_max - 1);
   buffer->count--;
-  if (buffer->start == buffer->element_max) 
-  {
-       buffer->start = 0;
-  }
 }
  
 void ringbuffer_popstack(ringbuffer_t *buffer, void* element) 
 {
-  int index;
   if (ringbuffer_empty(buffer))
   {
     return;
   } 
   /* LIFO implementation */
-  index = buffer->start + buffer->count - 1;
-  if (index >= buffer->element_max)
-  {
-    index = index - buffer->element_max;
-  }      
+  size_t index = (buffer->start + buffer->count - 1) & (buffer->element_max - 1);
   void* source = (buffer->element) + index * (buffer->element_size);
   buffer->count--;
   
@@ -117,12 +123,97 @@ size_t ringbuffer_get_count(ringbuffer_t* buffer)
   return buffer->count;
 }
 
-//Copy values XXX Copies popped elements too
-void ringbuffer_copy_data(void* target, ringbuffer_t* source)
+size_t ringbuffer_spans(ringbuffer_t* buffer, ringbuffer_span_t spans[2])
+{
+  if(ringbuffer_empty(buffer)) { return 0; }
+  size_t first = buffer->element_max - buffer->start;
+  spans[0].data = buffer->element + (buffer->start * buffer->element_size);
+  if(buffer->count <= first)
+  {
+    spans[0].count = buffer->count;
+    return 1;
+  }
+  spans[0].count = first;
+  spans[1].data = buffer->element;
+  spans[1].count = buffer->count - first;
+  return 2;
+}
+
+void ringbuffer_push_n(ringbuffer_t* buffer, const void* data, size_t n)
 {
-  void* start = source->element + (source->element_size * source->start);
-  size_t first_block_size = source->element_size * (source->element_max - source->start);
+  size_t mask = buffer->element_max - 1;
+  // Only the latest element_max elements would remain
+  if(n > buffer->element_max)
+  {
+    data += (n - buffer->element_max) * buffer->element_size;
+    buffer->start += n - buffer->element_max;
+    n = buffer->element_max;
+  }
+  size_t index = (buffer->start + buffer->count) & mask;
+  size_t first = buffer->element_max - index;
+  if(first > n) { first = n; }
+  memcpy(buffer->element + (index * buffer->element_size), data, first * buffer->element_size);
+  memcpy(buffer->element, data + (first * buffer->element_size), (n - first) * buffer->element_size);
+  buffer->count += n;
+  if(buffer->count > buffer->element_max)
+  {
+    buffer->start += buffer->count - buffer->element_max;
+    buffer->count = buffer->element_max;
+  }
+  buffer->start &= mask;
+}
+
+size_t ringbuffer_pop_n(ringbuffer_t* buffer, void* elements, size_t n)
+{
+  ringbuffer_span_t spans[2];
+  size_t num_spans = ringbuffer_spans(buffer, spans);
+  size_t popped = 0;
+  for(size_t ii = 0; ii < num_spans && popped < n; ii++)
+  {
+    size_t count = (spans[ii].count < n - popped) ? spans[ii].count : n - popped;
+    memcpy(elements + (popped * buffer->element_size), spans[ii].data, count * buffer->element_size);
+    popped += count;
+  }
+  buffer->start = (buffer->start + popped) & (buffer->element_max - 1);
+  buffer->count -= popped;
+  return popped;
+}
+
+size_t ringbuffer_copy_data(void* target, ringbuffer_t* source)
+{
+  ringbuffer_span_t spans[2];
+  size_t num_spans = ringbuffer_spans(source, spans);
+  size_t copied = 0;
   //Copy elements in order
-  memcpy(target, start, first_block_size);
-  memcpy(target + first_block_size, source->element, (source->element_size * source->element_max) - first_block_size);
+  for(size_t ii = 0; ii < num_spans; ii++)
+  {
+    memcpy(target + (copied * source->element_size), spans[ii].data, spans[ii].count * source->element_size);
+    copied += spans[ii].count;
+  }
+  return copied;
+}
+
+bool ringbuffer_spsc_push(ringbuffer_spsc_t* buffer, const void* data)
+{
+  uint32_t head = buffer->head;
+  uint32_t tail = __atomic_load_n(&buffer->tail, __ATOMIC_ACQUIRE);
+  if(head - tail > buffer->mask) { return false; }
+  memcpy(buffer->element + ((head & buffer->mask) * buffer->element_size), data, buffer->element_size);
+  __atomic_store_n(&buffer->head, head + 1, __ATOMIC_RELEASE);
+  return true;
+}
+
+bool ringbuffer_spsc_pop(ringbuffer_spsc_t* buffer, void* element)
+{
+  uint32_t tail = buffer->tail;
+  uint32_t head = __atomic_load_n(&buffer->head, __ATOMIC_ACQUIRE);
+  if(head == tail) { return false; }
+  memcpy(element, buffer->element + ((tail & buffer->mask) * buffer->element_size), buffer->element_size);
+  __atomic_store_n(&buffer->tail, tail + 1, __ATOMIC_RELEASE);
+  return true;
+}
+
+size_t ringbuffer_spsc_count(ringbuffer_spsc_t* buffer)
+{
+  return __atomic_load_n(&buffer->head, __ATOMIC_ACQUIRE) - __atomic_load_n(&buffer->tail, __ATOMIC_ACQUIRE);
 }
@@ -1,10 +1,15 @@
 #ifndef RINGBUFFER_H
 #define RINGBUFFER_H
 
+#include <stdbool.h>
 #include <stdlib.h>
 #include <stdint.h>
 
 // Based on https://jlmedina123.wordpress.com/2013/08/19/circular-buffer-queue/
+// Capacity is a power of two so that indices wrap by masking.
+
+// Evaluates to N - 1, fails to compile if N is not a power of two
+#define RINGBUFFER_MASK(N) ((N) - 1 + 0 * sizeof(char[((N) & ((N) - 1)) ? -1 : 1]))
 
 typedef struct{
     size_t element_max;  //Max number of elements
@@ -33,8 +38,29 @@ typedef struct{
 
 }ringbuffer_t;
 
-//Allocate memory for buffer. TODO: Return malloc status?
-void ringbuffer_init(ringbuffer_t* buffer, size_t  element_max, size_t element_size);
+/** Contiguous region of elements inside ringbuffer storage **/
+typedef struct{
+    void*  data;
+    size_t count; // number of elements
+}ringbuffer_span_t;
+
+/**
+ * Defines statically allocated ringbuffer name holding N elements of type.
+ * N must be a power of two, indices wrap by masking.
+ */
+#define RINGBUFFER_DEF(name, type, N)                                                   \
+  static type name##_elements[(N)];                                                   \
+  static ringbuffer_t name = { .element_max = RINGBUFFER_MASK(N) + 1,                 \
+                               .element_size = sizeof(type), .start = 0, .count = 0, \
+                               .element = name##_elements }
+
+//Allocate memory for buffer, element_max is rounded up to a power of two.
+//Return true if memory was allocated
+int ringbuffer_init(ringbuffer_t* buffer, size_t  element_max, size_t element_size);
+
+//Use given storage of element_max * element_size bytes, element_max must be a power of two.
+//Return true on success. Do not call ringbuffer_uninit on a static buffer.
+int ringbuffer_init_static(ringbuffer_t* buffer, void* storage, size_t element_max, size_t element_size);
 
 //Free resources of ringbuffer
 void ringbuffer_uninit(ringbuffer_t *buffer);
@@ -48,12 +74,18 @@ int ringbuffer_full(ringbuffer_t* buffer);
 //Return true if buffer is empty, false otherwise
 int ringbuffer_empty(ringbuffer_t* buffer);
 
-// Add element to buffer
+// Add element to buffer, overwrites oldest element if buffer is full
 void ringbuffer_push(ringbuffer_t* buffer, void* data);
 
+// Add n elements to buffer, overwrites oldest elements if buffer becomes full
+void ringbuffer_push_n(ringbuffer_t* buffer, const void* data, size_t n);
+
 // FIFO pop
 void ringbuffer_popqueue(ringbuffer_t* buffer, void* element);
 
+// FIFO pop of up to n elements, return number of elements popped
+size_t ringbuffer_pop_n(ringbuffer_t* buffer, void* elements, size_t n);
+
 // LIFO pop
 void ringbuffer_popstack(ringbuffer_t* buffer, void* element);
 
@@ -66,7 +98,51 @@ size_t ringbuffer_get_size(ringbuffer_t* buffer);
 //Get number of stored elements
 size_t ringbuffer_get_count(ringbuffer_t* buffer);
 
-//Copy values
-void ringbuffer_copy_data(void* target, ringbuffer_t* source);
+/**
+ * Get stored elements in place as one or two contiguous spans, oldest first.
+ * Spans are valid until buffer is modified.
+ * Return number of spans filled, 0 if buffer is empty.
+ */
+size_t ringbuffer_spans(ringbuffer_t* buffer, ringbuffer_span_t spans[2]);
+
+//Copy stored elements oldest first, target must have room for ringbuffer_get_count elements.
+//Return number of elements copied
+size_t ringbuffer_copy_data(void* target, ringbuffer_t* source);
+
+/**
+ * Single-producer single-consumer ring for handing events from an interrupt
+ * handler to main context without critical sections.
+ *
+ * Capacity is a power of two, head and tail run freely and are masked on access.
+ * Only the producer writes head and only the consumer writes tail; release stores
+ * publish the element before the index and acquire loads see the element after it.
+ * One producer and one consumer per ring: interrupts of different priorities need
+ * rings of their own. Full ring rejects new elements instead of overwriting.
+ */
+typedef struct{
+    size_t   mask;         // element_max - 1
+    size_t   element_size; // Element size in bytes
+    uint32_t head;         // Elements pushed, written by producer
+    uint32_t tail;         // Elements popped, written by consumer
+    void*    element;
+}ringbuffer_spsc_t;
+
+/**
+ * Defines statically allocated SPSC ring name holding N elements of type.
+ * N must be a power of two.
+ */
+#define RINGBUFFER_SPSC_DEF(name, type, N)                                                      \
+  static type name##_elements[(N)];                                                           \
+  static ringbuffer_spsc_t name = { .mask = RINGBUFFER_MASK(N), .element_size = sizeof(type), \
+                                    .head = 0, .tail = 0, .element = name##_elements }
+
+// Producer: add element, return false if ring is full
+bool ringbuffer_spsc_push(ringbuffer_spsc_t* buffer, const void* data);
+
+// Consumer: FIFO pop to element, return false if ring is empty
+bool ringbuffer_spsc_pop(ringbuffer_spsc_t* buffer, void* element);
+
+// Number of elements in ring, exact only when called by producer or consumer
+size_t ringbuffer_spsc_count(ringbuffer_spsc_t* buffer);
 
 #endif
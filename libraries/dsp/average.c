@@ -0,0 +1,20 @@
+#include "average.h"
+
+/** Keeps latest parameter samples in buffer and their sum in state **/
+void dsp_process_average(ringbuffer_t* values, const uint8_t parameter, const int16_t sample)
+{
+  dsp_state_t* state = &(DSP_FILTER(values)->state);
+  int32_t next = sample;
+  int32_t oldest;
+  if(dsp_window_push(values, parameter, &next, &oldest)) { state->average.sum -= oldest; }
+  state->average.sum += next;
+}
+
+/** Mean of window, rounded to nearest **/
+int32_t dsp_read_average(ringbuffer_t* values, const uint8_t parameter)
+{
+  int32_t count = ringbuffer_get_count(values);
+  if(0 == count) { return 0; }
+  int32_t sum = DSP_FILTER(values)->state.average.sum;
+  return (sum >= 0) ? (sum + count / 2) / count : (sum - count / 2) / count;
+}
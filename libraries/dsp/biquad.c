@@ -0,0 +1,40 @@
+#include "biquad.h"
+#include "dsp_simd.h"
+
+bool biquad_q14_init(biquad_q14_t* biquad, const int16_t coefficients[5])
+{
+  memset(biquad, 0, sizeof(*biquad));
+  if(INT16_MIN == coefficients[3] || INT16_MIN == coefficients[4]) { return false; }
+  biquad->b01 = dsp_pack16(coefficients[0], coefficients[1]);
+  biquad->b2  = coefficients[2];
+  biquad->a12 = dsp_pack16(-coefficients[3], -coefficients[4]);
+  return true;
+}
+
+void biquad_q14_process(biquad_q14_t* biquad, const int16_t* input, int16_t* output, size_t count)
+{
+  const uint32_t b01 = biquad->b01;
+  const uint32_t a12 = biquad->a12;
+  const int32_t  b2  = biquad->b2;
+  for(size_t axis = 0; axis < FIR_AXES; axis++)
+  {
+    int16_t  x1 = biquad->x[axis][0];
+    int16_t  x2 = biquad->x[axis][1];
+    uint32_t y  = biquad->y[axis];
+    for(size_t ii = 0; ii < count; ii++)
+    {
+      int16_t x0 = input[ii * FIR_AXES + axis];
+      uint32_t acc = dsp_smuad(dsp_pack16(x0, x1), b01);
+      acc = dsp_smlad(y, a12, acc);
+      acc += (uint32_t)(b2 * x2) + (1 << 13);  // Round to nearest
+      int16_t y0 = dsp_ssat16((int32_t)acc >> 14);
+      output[ii * FIR_AXES + axis] = y0;
+      x2 = x1;
+      x1 = x0;
+      y = dsp_pack16(y0, (int16_t)y);
+    }
+    biquad->x[axis][0] = x1;
+    biquad->x[axis][1] = x2;
+    biquad->y[axis] = y;
+  }
+}
@@ -0,0 +1,40 @@
+#ifndef BIQUAD_H
+#define BIQUAD_H
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "fir.h"
+
+/**
+ *  Q14 direct form I biquad for 3-axis int16 acceleration, samples interleaved as in fir.h.
+ *
+ *  y[n] = b0 x[n] + b1 x[n-1] + b2 x[n-2] - a1 y[n-1] - a2 y[n-2]
+ *
+ *  Coefficients are Q14 so that the range [-2, 2) of typical low and high pass sections fits.
+ *  Higher orders are built by cascading sections. Output saturates to int16.
+ *
+ *  Accumulation is 32 bits. Sum of absolute values of b0, b1, b2, a1 and a2 at most 65535
+ *  (just under 4.0) rules out overflow for any input. Sections with more gain, e.g. a high pass
+ *  close to 1.0, wrap on full scale steps; results still match between device and host.
+ */
+typedef struct{
+  uint32_t b01;                 // b0, b1 packed
+  uint32_t a12;                 // -a1, -a2 packed
+  int16_t  b2;
+  int16_t  x[FIR_AXES][2];      // x[n-1], x[n-2]
+  uint32_t y[FIR_AXES];         // y[n-1], y[n-2] packed
+}biquad_q14_t;
+
+/**
+ *  Initializes biquad with Q14 coefficients b0, b1, b2, a1, a2 (a0 is 1). State is cleared.
+ *  Returns false if a1 or a2 is -32768, which cannot be negated to int16.
+ */
+bool biquad_q14_init(biquad_q14_t* biquad, const int16_t coefficients[5]);
+
+/**
+ *  Filters count samples of FIR_AXES interleaved values from input to output.
+ *  Output may be the same buffer as input.
+ */
+void biquad_q14_process(biquad_q14_t* biquad, const int16_t* input, int16_t* output, size_t count);
+
+#endif
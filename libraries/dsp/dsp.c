@@ -1,5 +1,10 @@
 #include "dsp.h"
 #include "stdev.h"
+#include "average.h"
+#include "min_max.h"
+#include "impulse.h"
+#include "iir.h"
+#include "spectrum.h"
 #include "ruuvi_endpoints.h"
 #include "ringbuffer.h"
 
@@ -9,23 +14,103 @@
 #include "nrf_log.h"
 #include "nrf_log_ctrl.h"
 
+#define DSP_BLOCKS (DSP_POOL_WORDS / DSP_BLOCK_WORDS)
+static uint32_t m_pool[DSP_BLOCKS * DSP_BLOCK_WORDS];
+static bool m_block_used[DSP_BLOCKS];
+
+/** Take first free run of blocks holding length samples into use as ringbuffer of 32-bit elements.
+ *  Return false if there is none. **/
+static bool window_init(ringbuffer_t* z, uint8_t length)
+{
+  size_t element_max = DSP_BLOCK_WORDS;
+  while(element_max < length) { element_max <<= 1; }
+  size_t blocks = element_max / DSP_BLOCK_WORDS;
+  size_t run = 0;
+  for(size_t ii = 0; ii < DSP_BLOCKS; ii++)
+  {
+    run = m_block_used[ii] ? 0 : run + 1;
+    if(run < blocks) { continue; }
+    size_t first = ii + 1 - blocks;
+    for(size_t jj = first; jj <= ii; jj++) { m_block_used[jj] = true; }
+    return ringbuffer_init_static(z, &m_pool[first * DSP_BLOCK_WORDS], element_max, DSP_ELEMENT_SIZE);
+  }
+  NRF_LOG_ERROR("No free DSP window of %d samples\r\n", element_max);
+  return false;
+}
+
 dsp_filter_t dsp_init(ruuvi_dsp_function_t type, uint8_t dsp_parameter)
 {
   dsp_filter_t filter;
   memset(&filter, 0, sizeof(filter));
+  if(0 == dsp_parameter || DSP_WINDOW_MAX < dsp_parameter)
+  {
+    NRF_LOG_ERROR("Invalid DSP parameter %d\r\n", dsp_parameter);
+    return filter;
+  }
+  dsp_process process = NULL;
+  dsp_read read = NULL;
+  bool windowed = true;
   switch(type)
   {
+    case DSP_MIN:
+      process = dsp_process_min;
+      read = dsp_read_min;
+      break;
+
+    case DSP_MAX:
+      process = dsp_process_max;
+      read = dsp_read_max;
+      break;
+
+    case DSP_AVERAGE:
+      process = dsp_process_average;
+      read = dsp_read_average;
+      break;
+
     case DSP_STDEV:
-      filter.process = dsp_process_stdev;
-      filter.read = dsp_read_stdev;
-      filter.dsp_parameter = dsp_parameter;
-      ringbuffer_init(&filter.z, dsp_parameter, sizeof(float));
+      process = dsp_process_stdev;
+      read = dsp_read_stdev;
+      break;
+
+    case DSP_IMPULSE:
+      process = dsp_process_impulse;
+      read = dsp_read_impulse;
+      break;
+
+    case DSP_LOW_PASS:
+      process = dsp_process_iir;
+      read = dsp_read_low_pass;
+      filter.state.iir.coefficient = IIR_COEFFICIENT(dsp_parameter);
+      windowed = false;
+      break;
+
+    case DSP_HIGH_PASS:
+      process = dsp_process_iir;
+      read = dsp_read_high_pass;
+      filter.state.iir.coefficient = IIR_COEFFICIENT(dsp_parameter);
+      windowed = false;
+      break;
+
+    case DSP_SPECTRUM:
+      if(dsp_parameter >= SPECTRUM_BLOCK / 2)
+      {
+        NRF_LOG_ERROR("Invalid spectrum bin %d\r\n", dsp_parameter);
+        return filter;
+      }
+      goertzel_init(&filter.state.spectrum.goertzel, dsp_parameter, SPECTRUM_BLOCK);
+      process = dsp_process_spectrum;
+      read = dsp_read_spectrum;
+      windowed = false;
       break;
     
     default:
       NRF_LOG_ERROR("Unknown filter type\r\n");
-      break;
+      return filter;
   }
+  if(windowed && !window_init(&filter.z, dsp_parameter)) { return filter; }
+  filter.process = process;
+  filter.read = read;
+  filter.dsp_parameter = dsp_parameter;
   
   return filter;
 }
@@ -33,10 +118,41 @@ dsp_filter_t dsp_init(ruuvi_dsp_function_t type, uint8_t dsp_parameter)
 
 int dsp_is_init(dsp_filter_t* filter)
 {
-  return ringbuffer_is_init(&(filter->z));
+  return NULL != filter->process;
+}
+
+void dsp_process_block(dsp_filter_t* filter, const int16_t* samples, size_t n, size_t stride)
+{
+  dsp_process process = filter->process;
+  if(NULL == process) { return; }
+  ringbuffer_t* z = &(filter->z);
+  uint8_t parameter = filter->dsp_parameter;
+  for(size_t ii = 0; ii < n; ii++)
+  {
+    process(z, parameter, samples[ii * stride]);
+  }
+}
+
+bool dsp_window_push(ringbuffer_t* window, const uint8_t parameter, const void* sample, void* oldest)
+{
+  bool evicted = false;
+  if(ringbuffer_get_count(window) >= parameter)
+  {
+    ringbuffer_popqueue(window, oldest);
+    evicted = true;
+  }
+  ringbuffer_push(window, (void*)sample);
+  return evicted;
 }
 
 void dsp_uninit(dsp_filter_t* filter)
 {
-  ringbuffer_uninit(&(filter->z));
+  uint32_t* element = filter->z.element;
+  if(element >= m_pool && element < m_pool + DSP_BLOCKS * DSP_BLOCK_WORDS)
+  {
+    size_t first = (element - m_pool) / DSP_BLOCK_WORDS;
+    size_t blocks = filter->z.element_max / DSP_BLOCK_WORDS;
+    for(size_t ii = first; ii < first + blocks; ii++) { m_block_used[ii] = false; }
+  }
+  memset(filter, 0, sizeof(*filter));
 }
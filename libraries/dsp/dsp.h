@@ -1,35 +1,112 @@
 #ifndef DSP_H
 #define DSP_H
+#include <stddef.h>
 #include <stdlib.h>
 #include <math.h>
 
 #include "ringbuffer.h"
+#include "goertzel.h"
+
+/** Filters keep their previous values in a window taken from a statically allocated pool
+ *  of DSP_POOL_WORDS samples, so DSP RAM use is known at link time. A window takes the
+ *  parameter rounded up to a power of two, at least DSP_BLOCK_WORDS samples. Default pool
+ *  fits every state of all 16 chain channels with windows up to 16 samples. **/
+#ifndef DSP_WINDOW_MAX
+  #define DSP_WINDOW_MAX 64 // power of two
+#endif
+#ifndef DSP_BLOCK_WORDS
+  #define DSP_BLOCK_WORDS 8 // power of two, allocation granularity
+#endif
+#ifndef DSP_POOL_WORDS
+  #define DSP_POOL_WORDS 1024
+#endif
+
+/**
+ *  Filters run in fixed point so int16 sensor data is filtered without float conversions.
+ *  Samples are Q15, i.e. raw int16 values, and filter state is kept in 32-bit (Q31) accumulators.
+ *  Read values are in the scale of the samples and may exceed int16 range, i.e. high pass of a full-scale step.
+ **/
 
 /** DSP functions. Process: handles next sample. Does not necessarily calculate new state (i.e. FIR only cycles values) **/
-/** ringbuffer: previous values, uint8_t DSP parameter (i.e. dsp_filter_t.parameter, float: new value **/
-typedef void(*dsp_process)(ringbuffer_t* const, const uint8_t, const float);
+/** ringbuffer: previous values, uint8_t DSP parameter (i.e. dsp_filter_t.parameter, int16_t: new value **/
+typedef void(*dsp_process)(ringbuffer_t* const, const uint8_t, const int16_t);
 
 // Read returns current value, Calculates new state if necessary
-// float* values, uint8_t DSP parameter
-typedef float(*dsp_read)(ringbuffer_t*, uint8_t);
+// ringbuffer: previous values, uint8_t DSP parameter
+typedef int32_t(*dsp_read)(ringbuffer_t*, uint8_t);
+
+/** Running state of filters which do not recalculate from the window on every read **/
+typedef union{
+  struct{
+    float mean;
+    float m2;            // Sum of squared differences from mean
+    uint16_t evictions;  // Samples evicted since state was recalculated from window
+  }stdev;
+  struct{
+    int32_t sum;         // Sum of samples in window
+  }average;
+  struct{
+    uint16_t sequence;   // Number of next sample, wraps
+  }min_max;
+  struct{
+    int16_t previous;    // Latest sample
+    bool primed;         // Previous sample is valid
+  }impulse;
+  struct{
+    goertzel_t goertzel;
+    uint16_t amplitude;  // Result of latest complete block
+    uint8_t count;       // Samples in current block
+  }spectrum;
+  struct{
+    int32_t y;           // Low pass output, Q15.15
+    int32_t coefficient; // 1 / parameter, Q24
+    int16_t x;           // Latest sample
+    bool primed;         // Output is initialized to first sample
+  }iir;
+}dsp_state_t;
 
 typedef struct{
   ringbuffer_t z;
   uint8_t dsp_parameter;
   dsp_process process;
   dsp_read    read;
+  dsp_state_t state;
 }dsp_filter_t;
 
+/** Filter owning the window z, process and read functions are always called with &filter->z **/
+#define DSP_FILTER(window) ((dsp_filter_t*)((char*)(window) - offsetof(dsp_filter_t, z)))
+
+/** Window elements are 32 bits, int32_t for integer filters or float for STDEV **/
+#define DSP_ELEMENT_SIZE 4
+
 /**
  * Initialises filter of given type. 
- * Return initialized filter
+ * Return initialized filter, check with dsp_is_init. Initialization fails if type is unknown,
+ * dsp_parameter is 0 or larger than DSP_WINDOW_MAX, or pool has no free window of that length.
+ *
+ * dsp_parameter is the window length in samples for MIN, MAX, AVERAGE, STDEV and IMPULSE.
+ * LOW_PASS and HIGH_PASS are first order IIR filters with time constant of dsp_parameter
+ * samples, i.e. coefficient 1/dsp_parameter, and do not take a window.
+ * SPECTRUM is the amplitude at DFT bin dsp_parameter of 64 sample blocks, 1 ... 31. No window.
  **/
 dsp_filter_t dsp_init(uint8_t type, uint8_t dsp_parameter);
 
 int dsp_is_init();
 
 /**
- *  Releases resources allocated for the DSP filter
+ *  Processes n samples, i.e. one axis of interleaved data with stride 3 for x, y, z.
+ *  Equal to calling process for each of samples[0], samples[stride] ... samples[(n-1)*stride].
+ */
+void dsp_process_block(dsp_filter_t* filter, const int16_t* samples, size_t n, size_t stride);
+
+/**
+ *  Pushes sample to window holding the latest parameter samples.
+ *  Returns true and stores evicted sample to oldest if the window was full.
+ */
+bool dsp_window_push(ringbuffer_t* window, const uint8_t parameter, const void* sample, void* oldest);
+
+/**
+ *  Releases window of the DSP filter
  */
 void dsp_uninit(dsp_filter_t* filter);
 
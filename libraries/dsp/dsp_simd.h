@@ -0,0 +1,60 @@
+#ifndef DSP_SIMD_H
+#define DSP_SIMD_H
+#include <stdint.h>
+#include <string.h>
+
+/**
+ *  Dual 16-bit multiply-accumulate used by the FIR and biquad kernels.
+ *
+ *  On Cortex-M4 these are the SMLAD / SMUAD / SSAT instructions through CMSIS.
+ *  Elsewhere, i.e. in the host build, they are portable C with the same wrapping
+ *  32-bit accumulation, so kernel output is bit-exact between device and host.
+ *  Define DSP_SIMD_REFERENCE to use the portable versions on device too.
+ */
+#if defined(__ARM_FEATURE_DSP) && !defined(DSP_SIMD_REFERENCE)
+  #include "nrf.h"
+  #define DSP_SIMD 1
+  #define dsp_smlad(x, y, acc) __SMLAD((x), (y), (acc))
+  #define dsp_smuad(x, y)      __SMUAD((x), (y))
+  #define dsp_ssat16(x)        ((int16_t)__SSAT((x), 16))
+#else
+  #define DSP_SIMD 0
+
+/** acc + x.lo * y.lo + x.hi * y.hi, wraps on overflow **/
+static inline uint32_t dsp_smlad(uint32_t x, uint32_t y, uint32_t acc)
+{
+  int32_t lo = (int32_t)(int16_t)x * (int16_t)y;
+  int32_t hi = (int32_t)(int16_t)(x >> 16) * (int16_t)(y >> 16);
+  return acc + (uint32_t)lo + (uint32_t)hi;
+}
+
+/** x.lo * y.lo + x.hi * y.hi, wraps on overflow **/
+static inline uint32_t dsp_smuad(uint32_t x, uint32_t y)
+{
+  return dsp_smlad(x, y, 0);
+}
+
+/** Saturate to int16 **/
+static inline int16_t dsp_ssat16(int32_t x)
+{
+  if(x > INT16_MAX) { return INT16_MAX; }
+  if(x < INT16_MIN) { return INT16_MIN; }
+  return (int16_t)x;
+}
+#endif
+
+/** Pack two int16 to one word, lo in bits 0-15 **/
+static inline uint32_t dsp_pack16(int16_t lo, int16_t hi)
+{
+  return (uint16_t)lo | ((uint32_t)(uint16_t)hi << 16);
+}
+
+/** Load p[0] and p[1] as packed word, p does not need to be word aligned **/
+static inline uint32_t dsp_load16x2(const int16_t* p)
+{
+  uint32_t word;
+  memcpy(&word, p, sizeof(word));
+  return word;
+}
+
+#endif
@@ -0,0 +1,72 @@
+#include "fft.h"
+#include "vector.h"
+
+/** cos(2 pi k / 64), Q15, k = 0 ... 16 **/
+static const int16_t m_cos64[17] = {
+  32767, 32609, 32137, 31356, 30273, 28898, 27245, 25329,
+  23170, 20787, 18204, 15446, 12539,  9512,  6393,  3212, 0
+};
+
+int32_t dsp_cos64(const size_t k)
+{
+  return (k <= 16) ? m_cos64[k] : -m_cos64[32 - k];
+}
+
+/** sin(2 pi k / 64) for k = 0 ... 32 **/
+static int32_t sin64(const size_t k)
+{
+  return (k <= 16) ? m_cos64[16 - k] : m_cos64[k - 16];
+}
+
+/** Reverse the 6 index bits **/
+static size_t bit_reverse(size_t index)
+{
+  size_t reversed = 0;
+  for(size_t ii = 0; ii < 6; ii++)
+  {
+    reversed = (reversed << 1) | (index & 1);
+    index >>= 1;
+  }
+  return reversed;
+}
+
+void fft_q15_real64(const int16_t* samples, const size_t stride, uint16_t amplitude[FFT_BINS])
+{
+  int32_t re[FFT_LENGTH];
+  int32_t im[FFT_LENGTH];
+  for(size_t ii = 0; ii < FFT_LENGTH; ii++)
+  {
+    re[bit_reverse(ii)] = samples[ii * stride];
+    im[bit_reverse(ii)] = 0;
+  }
+
+  for(size_t half = 1; half < FFT_LENGTH; half <<= 1)
+  {
+    size_t twiddle_step = FFT_LENGTH / (2 * half);
+    for(size_t start = 0; start < FFT_LENGTH; start += 2 * half)
+    {
+      for(size_t ii = 0; ii < half; ii++)
+      {
+        // W = cos - j sin, b * W
+        int32_t wr = dsp_cos64(ii * twiddle_step);
+        int32_t wi = sin64(ii * twiddle_step);
+        size_t a = start + ii;
+        size_t b = a + half;
+        int32_t tr = (re[b] * wr + im[b] * wi + (1 << 14)) >> 15;
+        int32_t ti = (im[b] * wr - re[b] * wi + (1 << 14)) >> 15;
+        re[b] = (re[a] - tr) >> 1;
+        im[b] = (im[a] - ti) >> 1;
+        re[a] = (re[a] + tr) >> 1;
+        im[a] = (im[a] + ti) >> 1;
+      }
+    }
+  }
+
+  // Output is X / 64, amplitude of a sinusoid is 2 |X| / 64
+  for(size_t k = 0; k < FFT_BINS; k++)
+  {
+    uint32_t magnitude = dsp_isqrt32((uint32_t)(re[k] * re[k]) + (uint32_t)(im[k] * im[k]));
+    if(0 != k && FFT_BINS - 1 != k) { magnitude *= 2; }
+    amplitude[k] = (magnitude > UINT16_MAX) ? UINT16_MAX : (uint16_t)magnitude;
+  }
+}
@@ -0,0 +1,24 @@
+#ifndef FFT_H
+#define FFT_H
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ *  64-point fixed-point FFT of real int16 data, for a full vibration spectrum when a
+ *  Goertzel bank of a few bins is not enough. Radix-2 with Q15 twiddles, every stage
+ *  scales by 1/2 so that full scale input cannot overflow. Work area is 512 bytes of stack.
+ */
+#define FFT_LENGTH 64
+#define FFT_BINS   (FFT_LENGTH / 2 + 1)
+
+/**
+ *  Calculates amplitude spectrum of FFT_LENGTH samples at samples[ii * stride].
+ *  amplitude[k] is the peak amplitude of the component at k * fs / FFT_LENGTH in sample units,
+ *  amplitude[0] is the mean.
+ */
+void fft_q15_real64(const int16_t* samples, const size_t stride, uint16_t amplitude[FFT_BINS]);
+
+/** cos(2 pi k / 64) in Q15 for k = 0 ... 32, shared with Goertzel coefficients **/
+int32_t dsp_cos64(const size_t k);
+
+#endif
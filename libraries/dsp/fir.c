@@ -0,0 +1,53 @@
+#include "fir.h"
+#include "dsp_simd.h"
+
+bool fir_q15_init(fir_q15_t* fir, const int16_t* coefficients, const size_t taps)
+{
+  memset(fir, 0, sizeof(*fir));
+  if(0 == taps || FIR_TAPS_MAX < taps) { return false; }
+  // Odd filters get a zero tap at the end, store reversed so that a window of samples
+  // from oldest to newest multiplies coefficients in order.
+  fir->taps = (taps + 1) & ~1;
+  for(size_t ii = 0; ii < taps; ii++)
+  {
+    fir->coefficients[fir->taps - 1 - ii] = coefficients[ii];
+  }
+  return true;
+}
+
+/** Filters n <= FIR_BLOCK_MAX samples of each axis **/
+static void fir_q15_block(fir_q15_t* fir, const int16_t* input, int16_t* output, size_t n)
+{
+  const size_t taps = fir->taps;
+  const size_t history = taps - 1;
+  int16_t window[FIR_TAPS_MAX - 1 + FIR_BLOCK_MAX];
+  for(size_t axis = 0; axis < FIR_AXES; axis++)
+  {
+    // Previous samples followed by this block of the axis
+    memcpy(window, fir->history[axis], history * sizeof(int16_t));
+    for(size_t ii = 0; ii < n; ii++) { window[history + ii] = input[ii * FIR_AXES + axis]; }
+
+    for(size_t ii = 0; ii < n; ii++)
+    {
+      uint32_t acc = 1 << 14;  // Round to nearest
+      for(size_t jj = 0; jj < taps; jj += 2)
+      {
+        acc = dsp_smlad(dsp_load16x2(&window[ii + jj]), dsp_load16x2(&fir->coefficients[jj]), acc);
+      }
+      output[ii * FIR_AXES + axis] = dsp_ssat16((int32_t)acc >> 15);
+    }
+    memcpy(fir->history[axis], &window[n], history * sizeof(int16_t));
+  }
+}
+
+void fir_q15_process(fir_q15_t* fir, const int16_t* input, int16_t* output, size_t count)
+{
+  while(count)
+  {
+    size_t n = (count < FIR_BLOCK_MAX) ? count : FIR_BLOCK_MAX;
+    fir_q15_block(fir, input, output, n);
+    input  += n * FIR_AXES;
+    output += n * FIR_AXES;
+    count  -= n;
+  }
+}
@@ -0,0 +1,41 @@
+#ifndef FIR_H
+#define FIR_H
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ *  Q15 FIR filter for 3-axis int16 acceleration.
+ *
+ *  Samples are interleaved x, y, z as in lis2dh12 acceleration_t. Each axis has its
+ *  own delay line, all axes share the coefficients. Dot products take two taps per
+ *  SMLAD, see dsp_simd.h.
+ *
+ *  Accumulation is 32 bits, coefficients should have sum of absolute values at most 1.0
+ *  (32768) to rule out overflow.
+ */
+#define FIR_AXES      3
+#ifndef FIR_TAPS_MAX
+  #define FIR_TAPS_MAX  32 // even
+#endif
+#define FIR_BLOCK_MAX 32   // Samples per axis filtered at a time, i.e. LIS2DH12 FIFO
+
+typedef struct{
+  int16_t coefficients[FIR_TAPS_MAX];         // Reversed and padded to even number of taps
+  uint8_t taps;                               // Even
+  int16_t history[FIR_AXES][FIR_TAPS_MAX];    // taps - 1 previous samples of each axis, oldest first
+}fir_q15_t;
+
+/**
+ *  Initializes filter with taps Q15 coefficients h[0] ... h[taps - 1], y[n] = sum h[k] * x[n - k].
+ *  History is cleared. Returns false if taps is 0 or larger than FIR_TAPS_MAX.
+ */
+bool fir_q15_init(fir_q15_t* fir, const int16_t* coefficients, const size_t taps);
+
+/**
+ *  Filters count samples of FIR_AXES interleaved values from input to output.
+ *  Output may be the same buffer as input.
+ */
+void fir_q15_process(fir_q15_t* fir, const int16_t* input, int16_t* output, size_t count);
+
+#endif
@@ -0,0 +1,67 @@
+#include "goertzel.h"
+#include <string.h>
+#include "vector.h"
+#include "fft.h"
+
+void goertzel_init(goertzel_t* goertzel, const uint8_t bin, const uint8_t length)
+{
+  memset(goertzel, 0, sizeof(*goertzel));
+  // Length divides 64, bin k of length is bin k * 64 / length of table
+  uint8_t k = bin * (64 / length);
+  goertzel->coefficient = (int16_t)dsp_cos64(k);  // 2 cos in Q14 is cos in Q15
+}
+
+uint16_t goertzel_finish(goertzel_t* goertzel, const uint8_t length)
+{
+  // |X|^2 = s1^2 + s2^2 - coefficient s1 s2, |X| = amplitude * length / 2
+  int64_t s1 = goertzel->s1;
+  int64_t s2 = goertzel->s2;
+  int64_t power = s1 * s1 + s2 * s2 - ((goertzel->coefficient * s1) >> 14) * s2;
+  goertzel->s1 = 0;
+  goertzel->s2 = 0;
+  if(power <= 0) { return 0; }
+  uint32_t amplitude = 2 * dsp_isqrt64((uint64_t)power) / length;
+  return (amplitude > UINT16_MAX) ? UINT16_MAX : (uint16_t)amplitude;
+}
+
+bool goertzel_bank_init(goertzel_bank_t* bank, const uint8_t* bins, const size_t count, const uint8_t length)
+{
+  memset(bank, 0, sizeof(*bank));
+  if(GOERTZEL_BINS_MAX < count || 0 == length || GOERTZEL_BLOCK_MAX < length || 64 % length) { return false; }
+  for(size_t ii = 0; ii < count; ii++)
+  {
+    if(0 == bins[ii] || bins[ii] >= length / 2) { return false; }
+    goertzel_init(&bank->bin[ii], bins[ii], length);
+  }
+  bank->bins = count;
+  bank->length = length;
+  return true;
+}
+
+size_t goertzel_bank_process(goertzel_bank_t* bank, const int16_t* samples, size_t n, size_t stride)
+{
+  size_t blocks = 0;
+  while(n)
+  {
+    size_t remaining = bank->length - bank->count;
+    size_t block = (n < remaining) ? n : remaining;
+    for(size_t bin = 0; bin < bank->bins; bin++)
+    {
+      goertzel_t* goertzel = &bank->bin[bin];
+      for(size_t ii = 0; ii < block; ii++) { goertzel_step(goertzel, samples[ii * stride]); }
+    }
+    samples += block * stride;
+    n -= block;
+    bank->count += block;
+    if(bank->count == bank->length)
+    {
+      for(size_t bin = 0; bin < bank->bins; bin++)
+      {
+        bank->amplitude[bin] = goertzel_finish(&bank->bin[bin], bank->length);
+      }
+      bank->count = 0;
+      blocks++;
+    }
+  }
+  return blocks;
+}
@@ -0,0 +1,63 @@
+#ifndef GOERTZEL_H
+#define GOERTZEL_H
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ *  Goertzel detectors for the amplitude of a handful of frequencies in int16 data.
+ *
+ *  Each detector evaluates one DFT bin over a block of samples, bin k of a block of N samples
+ *  at sample rate fs is the frequency k * fs / N. I.e. LIS2DH12 at 400 Hz with 64 sample
+ *  blocks has 6.25 Hz bins. Cost is one multiply-accumulate per sample and bin.
+ *
+ *  Amplitude is the peak amplitude of a sinusoid at the bin frequency, in sample units.
+ */
+#define GOERTZEL_BLOCK_MAX  64
+#ifndef GOERTZEL_BINS_MAX
+  #define GOERTZEL_BINS_MAX 8
+#endif
+
+typedef struct{
+  int16_t coefficient;  // 2 cos(2 pi k / N), Q14
+  int32_t s1;           // Previous two outputs of the resonator
+  int32_t s2;
+}goertzel_t;
+
+typedef struct{
+  goertzel_t bin[GOERTZEL_BINS_MAX];
+  uint16_t amplitude[GOERTZEL_BINS_MAX];  // Result of latest complete block
+  uint8_t bins;
+  uint8_t length;                         // Samples per block
+  uint8_t count;                          // Samples in current block
+}goertzel_bank_t;
+
+/** Initializes detector for bin of block of length samples, length is a power of two up to 64 **/
+void goertzel_init(goertzel_t* goertzel, const uint8_t bin, const uint8_t length);
+
+/** Adds sample to block **/
+static inline void goertzel_step(goertzel_t* goertzel, const int16_t sample)
+{
+  // Product needs more than 32 bits at resonance
+  int32_t s0 = sample + (int32_t)(((int64_t)goertzel->coefficient * goertzel->s1) >> 14) - goertzel->s2;
+  goertzel->s2 = goertzel->s1;
+  goertzel->s1 = s0;
+}
+
+/** Returns amplitude of complete block of length samples and clears detector for next block **/
+uint16_t goertzel_finish(goertzel_t* goertzel, const uint8_t length);
+
+/**
+ *  Initializes bank of bins, i.e. {2, 4, 8} for 12.5, 25 and 50 Hz at 400 Hz and length 64.
+ *  Returns false if there are more than GOERTZEL_BINS_MAX bins, length is not a power of two
+ *  up to GOERTZEL_BLOCK_MAX, or a bin is outside 1 ... length / 2 - 1.
+ */
+bool goertzel_bank_init(goertzel_bank_t* bank, const uint8_t* bins, const size_t count, const uint8_t length);
+
+/**
+ *  Processes n samples at samples[ii * stride]. Amplitudes are updated at the end of each block.
+ *  Returns number of blocks completed.
+ */
+size_t goertzel_bank_process(goertzel_bank_t* bank, const int16_t* samples, size_t n, size_t stride);
+
+#endif
@@ -0,0 +1,32 @@
+#include "iir.h"
+
+/** Fractional bits of low pass output, difference of two Q15.15 values fits 32 bits **/
+#define IIR_FRACTION_BITS 15
+
+void dsp_process_iir(ringbuffer_t* values, const uint8_t parameter, const int16_t sample)
+{
+  dsp_state_t* state = &(DSP_FILTER(values)->state);
+  int32_t x = (int32_t)sample * (1 << IIR_FRACTION_BITS);
+  state->iir.x = sample;
+  // Start from first sample instead of ramping up from 0
+  if(!state->iir.primed)
+  {
+    state->iir.y = x;
+    state->iir.primed = true;
+    return;
+  }
+  // Multiply by reciprocal of parameter, 32 x 32 -> 64 bit multiply is one instruction on Cortex-M4
+  int32_t difference = x - state->iir.y;
+  state->iir.y += (int32_t)(((int64_t)difference * state->iir.coefficient) >> IIR_COEFFICIENT_BITS);
+}
+
+int32_t dsp_read_low_pass(ringbuffer_t* values, const uint8_t parameter)
+{
+  int32_t y = DSP_FILTER(values)->state.iir.y;
+  return (y + (1 << (IIR_FRACTION_BITS - 1))) >> IIR_FRACTION_BITS;
+}
+
+int32_t dsp_read_high_pass(ringbuffer_t* values, const uint8_t parameter)
+{
+  return DSP_FILTER(values)->state.iir.x - dsp_read_low_pass(values, parameter);
+}
@@ -0,0 +1,18 @@
+#ifndef IIR_H
+#define IIR_H
+
+#include "dsp.h"
+
+/** Fractional bits of dsp_state_t iir.coefficient **/
+#define IIR_COEFFICIENT_BITS 24
+
+/** Coefficient for dsp_state_t iir.coefficient, reciprocal of parameter **/
+#define IIR_COEFFICIENT(parameter) (((1UL << IIR_COEFFICIENT_BITS) + (parameter) / 2) / (parameter))
+
+/** First order IIR low pass y += (x - y) / parameter, high pass is x - y.
+ *  Division is a multiplication by IIR_COEFFICIENT(parameter), set by dsp_init. **/
+void dsp_process_iir(ringbuffer_t* values, const uint8_t parameter, const int16_t sample);
+int32_t dsp_read_low_pass(ringbuffer_t* values, const uint8_t parameter);
+int32_t dsp_read_high_pass(ringbuffer_t* values, const uint8_t parameter);
+
+#endif
@@ -0,0 +1,22 @@
+#include "impulse.h"
+#include "min_max.h"
+
+/** Keeps absolute differences of consecutive samples in window **/
+void dsp_process_impulse(ringbuffer_t* values, const uint8_t parameter, const int16_t sample)
+{
+  dsp_state_t* state = &(DSP_FILTER(values)->state);
+  if(state->impulse.primed)
+  {
+    int32_t difference = abs((int32_t)sample - state->impulse.previous);
+    int32_t oldest;
+    dsp_window_push(values, parameter, &difference, &oldest);
+  }
+  state->impulse.previous = sample;
+  state->impulse.primed = true;
+}
+
+/** Largest sample-to-sample change in window **/
+int32_t dsp_read_impulse(ringbuffer_t* values, const uint8_t parameter)
+{
+  return dsp_window_max(values);
+}
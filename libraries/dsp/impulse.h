@@ -0,0 +1,9 @@
+#ifndef IMPULSE_H
+#define IMPULSE_H
+
+#include "dsp.h"
+
+void dsp_process_impulse(ringbuffer_t* values, const uint8_t parameter, const int16_t sample);
+int32_t dsp_read_impulse(ringbuffer_t* values, const uint8_t parameter);
+
+#endif
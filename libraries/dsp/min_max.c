@@ -0,0 +1,78 @@
+#include "min_max.h"
+
+/**
+ *  MIN and MAX keep a monotonic deque in the window instead of the samples.
+ *  Deque holds the samples which can still become the extreme of the window, oldest first,
+ *  each packed with the low 16 bits of its sequence number to find out when it leaves the window.
+ *  Every sample is pushed and popped at most once, so process is amortised O(1) and read is O(1).
+ */
+#define DEQUE_VALUE(element)    ((int16_t)((element) & 0xFFFF))
+#define DEQUE_SEQUENCE(element) ((uint16_t)((uint32_t)(element) >> 16))
+
+static void deque_push(ringbuffer_t* values, const uint8_t parameter, const int16_t sample, const bool max)
+{
+  // Deque is handled in place, peek and pop copies would cost more than the comparisons
+  dsp_state_t* state = &(DSP_FILTER(values)->state);
+  int32_t* elements = values->element;
+  const size_t mask = values->element_max - 1;
+  uint16_t sequence = state->min_max.sequence++;
+  size_t count = values->count;
+
+  // Drop oldest if it leaves the window, before push so that deque fits parameter samples
+  if(count && (uint16_t)(sequence - DEQUE_SEQUENCE(elements[values->start])) >= parameter)
+  {
+    values->start = (values->start + 1) & mask;
+    count--;
+  }
+
+  // Drop samples which are never the extreme again, new sample is newer and at least as extreme
+  while(count)
+  {
+    int16_t newest = DEQUE_VALUE(elements[(values->start + count - 1) & mask]);
+    if(max ? (newest > sample) : (newest < sample)) { break; }
+    count--;
+  }
+  elements[(values->start + count) & mask] = (int32_t)(((uint32_t)sequence << 16) | (uint16_t)sample);
+  values->count = count + 1;
+}
+
+/** Extreme of the window is the oldest sample in deque **/
+static int32_t deque_read(ringbuffer_t* values)
+{
+  if(ringbuffer_empty(values)) { return 0; }
+  return DEQUE_VALUE(((int32_t*)values->element)[values->start]);
+}
+
+void dsp_process_min(ringbuffer_t* values, const uint8_t parameter, const int16_t sample)
+{
+  deque_push(values, parameter, sample, false);
+}
+
+void dsp_process_max(ringbuffer_t* values, const uint8_t parameter, const int16_t sample)
+{
+  deque_push(values, parameter, sample, true);
+}
+
+int32_t dsp_read_min(ringbuffer_t* values, const uint8_t parameter)
+{
+  return deque_read(values);
+}
+
+int32_t dsp_read_max(ringbuffer_t* values, const uint8_t parameter)
+{
+  return deque_read(values);
+}
+
+int32_t dsp_window_max(ringbuffer_t* values)
+{
+  ringbuffer_span_t spans[2];
+  size_t num_spans = ringbuffer_spans(values, spans);
+  if(0 == num_spans) { return 0; }
+  int32_t max = INT32_MIN;
+  for(size_t ii = 0; ii < num_spans; ii++)
+  {
+    const int32_t* samples = spans[ii].data;
+    for(size_t jj = 0; jj < spans[ii].count; jj++) { if(samples[jj] > max) { max = samples[jj]; } }
+  }
+  return max;
+}
@@ -0,0 +1,14 @@
+#ifndef MIN_MAX_H
+#define MIN_MAX_H
+
+#include "dsp.h"
+
+void dsp_process_min(ringbuffer_t* values, const uint8_t parameter, const int16_t sample);
+void dsp_process_max(ringbuffer_t* values, const uint8_t parameter, const int16_t sample);
+int32_t dsp_read_min(ringbuffer_t* values, const uint8_t parameter);
+int32_t dsp_read_max(ringbuffer_t* values, const uint8_t parameter);
+
+/** Largest value in window of int32_t, 0 if window is empty **/
+int32_t dsp_window_max(ringbuffer_t* values);
+
+#endif
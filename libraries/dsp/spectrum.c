@@ -0,0 +1,16 @@
+#include "spectrum.h"
+
+void dsp_process_spectrum(ringbuffer_t* values, const uint8_t parameter, const int16_t sample)
+{
+  dsp_state_t* state = &(DSP_FILTER(values)->state);
+  goertzel_step(&state->spectrum.goertzel, sample);
+  if(++state->spectrum.count < SPECTRUM_BLOCK) { return; }
+  state->spectrum.amplitude = goertzel_finish(&state->spectrum.goertzel, SPECTRUM_BLOCK);
+  state->spectrum.count = 0;
+}
+
+/** Amplitude of latest complete block **/
+int32_t dsp_read_spectrum(ringbuffer_t* values, const uint8_t parameter)
+{
+  return DSP_FILTER(values)->state.spectrum.amplitude;
+}
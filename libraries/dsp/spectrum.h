@@ -0,0 +1,12 @@
+#ifndef SPECTRUM_H
+#define SPECTRUM_H
+
+#include "dsp.h"
+
+/** DSP_SPECTRUM: amplitude at bin parameter of SPECTRUM_BLOCK sample blocks, see goertzel.h **/
+#define SPECTRUM_BLOCK GOERTZEL_BLOCK_MAX
+
+void dsp_process_spectrum(ringbuffer_t* values, const uint8_t parameter, const int16_t sample);
+int32_t dsp_read_spectrum(ringbuffer_t* values, const uint8_t parameter);
+
+#endif
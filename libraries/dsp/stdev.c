@@ -1,36 +1,72 @@
 #include "stdev.h"
 #include "math.h"
 
-void dsp_process_stdev(ringbuffer_t* values, const uint8_t parameter, const float next)
-{
-  //Only push latest sample to buffer
-  ringbuffer_push(values, (void*)&next);
-}
+/** Rounding errors of running state accumulate, recalculate state from window after this many evictions **/
+#define STDEV_REFRESH_INTERVAL 1024
 
-float dsp_read_stdev(ringbuffer_t* values, const uint8_t parameter)
+/** Calculates mean and squared differences of the window, O(window) **/
+static void stdev_refresh(ringbuffer_t* values)
 {
-  // Calculate mean
+  dsp_state_t* state = &(DSP_FILTER(values)->state);
+  size_t count = ringbuffer_get_count(values);
+  ringbuffer_span_t spans[2];
+  size_t num_spans = ringbuffer_spans(values, spans);
+
   float mean = 0.0f;
-  //Store peeked values for variance
-  float samples[parameter];
-  for(size_t ii = 0; ii < parameter; ii ++)
+  for(size_t ii = 0; ii < num_spans; ii++)
+  {
+    const float* samples = spans[ii].data;
+    for(size_t jj = 0; jj < spans[ii].count; jj++) { mean += samples[jj]; }
+  }
+  mean /= count;
+
+  float m2 = 0.0f;
+  for(size_t ii = 0; ii < num_spans; ii++)
   {
-    float value;
-    ringbuffer_peek_at(values, ii, &value);
-    samples[ii] = value;
-    mean += value;
+    const float* samples = spans[ii].data;
+    for(size_t jj = 0; jj < spans[ii].count; jj++)
+    {
+      float difference = samples[jj] - mean;
+      m2 += difference*difference;
+    }
   }
-  mean/=parameter;
 
-  // Calculate variance
-  float variance = 0.0f;
-  for(int ii = 0; ii < parameter; ii++)
+  state->stdev.mean = mean;
+  state->stdev.m2 = m2;
+  state->stdev.evictions = 0;
+}
+
+/**
+ *  Keeps latest parameter samples in buffer and updates mean and squared differences
+ *  with Welford's method, adding the new sample and removing the evicted one.
+ */
+void dsp_process_stdev(ringbuffer_t* values, const uint8_t parameter, const int16_t sample)
+{
+  dsp_state_t* state = &(DSP_FILTER(values)->state);
+  float mean = state->stdev.mean;
+  float next = sample;
+  float oldest;
+
+  if(!dsp_window_push(values, parameter, &next, &oldest))
   {
-    float difference = samples[ii] - mean;
-    variance += difference*difference;
+    float difference = next - mean;
+    state->stdev.mean = mean + difference / ringbuffer_get_count(values);
+    state->stdev.m2  += difference * (next - state->stdev.mean);
+    return;
   }
 
-  variance /= parameter;
+  // Window was full, oldest sample was replaced
+  float next_mean = mean + (next - oldest) / parameter;
+  state->stdev.m2  += (next - oldest) * (next - next_mean + oldest - mean);
+  state->stdev.mean = next_mean;
+  if(++state->stdev.evictions >= STDEV_REFRESH_INTERVAL) { stdev_refresh(values); }
+}
 
-  return sqrt(variance);
+int32_t dsp_read_stdev(ringbuffer_t* values, const uint8_t parameter)
+{
+  size_t count = ringbuffer_get_count(values);
+  if(0 == count) { return 0; }
+  float variance = DSP_FILTER(values)->state.stdev.m2 / count;
+  // Rounding may leave constant signal slightly negative
+  return (variance > 0.0f) ? (int32_t)sqrtf(variance) : 0;
 }
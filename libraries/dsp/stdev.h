@@ -3,7 +3,7 @@
 
 #include "dsp.h"
 
-void dsp_process_stdev(ringbuffer_t* values, const uint8_t parameter, const float next);
-float dsp_read_stdev(ringbuffer_t* values, const uint8_t parameter);
+void dsp_process_stdev(ringbuffer_t* values, const uint8_t parameter, const int16_t sample);
+int32_t dsp_read_stdev(ringbuffer_t* values, const uint8_t parameter);
 
 #endif
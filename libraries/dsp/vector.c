@@ -0,0 +1,107 @@
+#include "vector.h"
+#include <stdbool.h>
+
+/** Digit-by-digit square root, one result bit per iteration **/
+uint16_t dsp_isqrt32(uint32_t value)
+{
+  uint32_t root = 0;
+  uint32_t bit = 1UL << 30;
+  while(bit > value) { bit >>= 2; }
+  while(bit)
+  {
+    if(value >= root + bit)
+    {
+      value -= root + bit;
+      root = (root >> 1) + bit;
+    }
+    else
+    {
+      root >>= 1;
+    }
+    bit >>= 2;
+  }
+  return (uint16_t)root;
+}
+
+uint32_t dsp_isqrt64(uint64_t value)
+{
+  if(value <= UINT32_MAX) { return dsp_isqrt32((uint32_t)value); }
+  uint64_t root = 0;
+  uint64_t bit = 1ULL << 62;
+  while(bit > value) { bit >>= 2; }
+  while(bit)
+  {
+    if(value >= root + bit)
+    {
+      value -= root + bit;
+      root = (root >> 1) + bit;
+    }
+    else
+    {
+      root >>= 1;
+    }
+    bit >>= 2;
+  }
+  return (uint32_t)root;
+}
+
+uint16_t dsp_vector_magnitude(const int16_t x, const int16_t y, const int16_t z)
+{
+  // Each square is at most 2^30, sum fits in uint32
+  uint32_t sum = (uint32_t)((int32_t)x * x) + (uint32_t)((int32_t)y * y) + (uint32_t)((int32_t)z * z);
+  return dsp_isqrt32(sum);
+}
+
+void dsp_vector_magnitude_block(const int16_t* samples, size_t count, size_t stride,
+                                int16_t* magnitude, size_t magnitude_stride)
+{
+  for(size_t ii = 0; ii < count; ii++)
+  {
+    const int16_t* sample = &samples[ii * stride];
+    uint16_t value = dsp_vector_magnitude(sample[0], sample[1], sample[2]);
+    magnitude[ii * magnitude_stride] = (value > INT16_MAX) ? INT16_MAX : (int16_t)value;
+  }
+}
+
+int16_t dsp_atan2(const int32_t y, const int32_t x)
+{
+  uint32_t ax = (x < 0) ? 0U - (uint32_t)x : (uint32_t)x;
+  uint32_t ay = (y < 0) ? 0U - (uint32_t)y : (uint32_t)y;
+  if(0 == ax && 0 == ay) { return 0; }
+  bool steep = ay > ax;
+  uint32_t num = steep ? ax : ay;
+  uint32_t den = steep ? ay : ax;
+  // z = num / den in Q15, 0 ... 1
+  uint32_t z = (uint32_t)(((uint64_t)num << 15) / den);
+  uint64_t angle = 450ULL * z + ((uint64_t)z * ((1UL << 15) - z) * 15642ULL) / (100ULL << 15);
+  int32_t result = (int32_t)((angle + (1UL << 14)) >> 15);
+  if(steep) { result = 900 - result; }
+  if(x < 0) { result = 1800 - result; }
+  return (y < 0) ? -result : result;
+}
+
+/** Shift vector so that components are below 2^14, cross product squares then sum below 2^63 **/
+static void vector_reduce(const int16_t in[3], int32_t out[3])
+{
+  int32_t max = 0;
+  for(size_t ii = 0; ii < 3; ii++)
+  {
+    int32_t value = (in[ii] < 0) ? -in[ii] : in[ii];
+    if(value > max) { max = value; }
+  }
+  uint8_t shift = (max >= (1 << 14)) ? 2 : 0;
+  for(size_t ii = 0; ii < 3; ii++) { out[ii] = in[ii] >> shift; }
+}
+
+int16_t dsp_vector_angle(const int16_t a[3], const int16_t b[3])
+{
+  int32_t u[3], v[3];
+  vector_reduce(a, u);
+  vector_reduce(b, v);
+  int64_t cx = (int64_t)u[1] * v[2] - (int64_t)u[2] * v[1];
+  int64_t cy = (int64_t)u[2] * v[0] - (int64_t)u[0] * v[2];
+  int64_t cz = (int64_t)u[0] * v[1] - (int64_t)u[1] * v[0];
+  uint32_t cross = dsp_isqrt64((uint64_t)(cx * cx) + (uint64_t)(cy * cy) + (uint64_t)(cz * cz));
+  int32_t dot = u[0] * v[0] + u[1] * v[1] + u[2] * v[2];
+  return dsp_atan2((int32_t)cross, dot);
+}
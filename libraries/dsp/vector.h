@@ -0,0 +1,37 @@
+#ifndef VECTOR_H
+#define VECTOR_H
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ *  Integer kernels for DSP_VECTOR, the magnitude of a 3-axis sample.
+ *
+ *  Sum of squares of int16 axes fits in 32 bits unsigned and the integer square root
+ *  is exact, so the magnitude is floor(sqrt(x^2 + y^2 + z^2)) without libm or overflow.
+ */
+
+/** floor(sqrt(value)) **/
+uint16_t dsp_isqrt32(uint32_t value);
+uint32_t dsp_isqrt64(uint64_t value);
+
+/** Magnitude of vector, up to 56755 for full scale int16 axes **/
+uint16_t dsp_vector_magnitude(const int16_t x, const int16_t y, const int16_t z);
+
+/**
+ *  Calculates magnitude of count samples of x, y, z at samples[ii * stride],
+ *  to magnitude[ii * magnitude_stride] saturated to INT16_MAX.
+ *  I.e. interleaved x, y, z, magnitude frames use stride 4 and magnitude = samples + 3.
+ */
+void dsp_vector_magnitude_block(const int16_t* samples, size_t count, size_t stride,
+                                int16_t* magnitude, size_t magnitude_stride);
+
+/**
+ *  Angle of (x, y) in 0.1 degrees, -1800 ... 1800, 0 for (0, 0).
+ *  Octant reduction and atan(z) = 45 z + 15.64 z (1 - z) degrees, error below 0.3 degrees.
+ */
+int16_t dsp_atan2(const int32_t y, const int32_t x);
+
+/** Angle between vectors a and b in 0.1 degrees, 0 ... 1800, 0 if either is zero **/
+int16_t dsp_vector_angle(const int16_t a[3], const int16_t b[3]);
+
+#endif
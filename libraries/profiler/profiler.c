@@ -0,0 +1,81 @@
+#include "profiler.h"
+#include <string.h>
+
+#ifdef HOST_BUILD
+  #include <time.h>
+#endif
+
+static profiler_stats_t m_stats[PROFILER_PROBES];
+
+#ifdef HOST_BUILD
+/** Host fallback: monotonic clock in target core cycles, wraps like CYCCNT **/
+uint32_t profiler_cycles(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  uint64_t ns = (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+  return (uint32_t)((ns * (PROFILER_CORE_CLOCK_HZ / 1000000u)) / 1000u);
+}
+#endif
+
+void profiler_init(void)
+{
+#ifndef HOST_BUILD
+  CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+  DWT->CYCCNT = 0;
+  DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+#endif
+  profiler_reset();
+}
+
+void profiler_reset(void)
+{
+  memset(m_stats, 0, sizeof(m_stats));
+  for(size_t ii = 0; ii < PROFILER_PROBES; ii++)
+  {
+    m_stats[ii].min = UINT32_MAX;
+  }
+}
+
+void profiler_record(profiler_probe_t probe, uint32_t cycles)
+{
+  if(PROFILER_PROBES <= probe) { return; }
+  profiler_stats_t* stats = &m_stats[probe];
+  stats->count++;
+  stats->total += cycles;
+  if(cycles < stats->min) { stats->min = cycles; }
+  if(cycles > stats->max) { stats->max = cycles; }
+}
+
+const profiler_stats_t* profiler_stats_get(profiler_probe_t probe)
+{
+  if(PROFILER_PROBES <= probe) { return NULL; }
+  return &m_stats[probe];
+}
+
+static uint8_t* put_uint32(uint8_t* buffer, uint32_t value)
+{
+  buffer[0] = value;
+  buffer[1] = value >> 8;
+  buffer[2] = value >> 16;
+  buffer[3] = value >> 24;
+  return buffer + 4;
+}
+
+size_t profiler_serialize(uint8_t* buffer, size_t length)
+{
+  if(NULL == buffer || PROFILER_SERIALIZED_LENGTH > length) { return 0; }
+  uint8_t* p = buffer;
+  *p++ = PROFILER_FORMAT_VERSION;
+  *p++ = PROFILER_PROBES;
+  p = put_uint32(p, PROFILER_CORE_CLOCK_HZ);
+  for(size_t ii = 0; ii < PROFILER_PROBES; ii++)
+  {
+    const profiler_stats_t* stats = &m_stats[ii];
+    p = put_uint32(p, stats->count);
+    p = put_uint32(p, stats->count ? stats->min : 0);
+    p = put_uint32(p, stats->max);
+    p = put_uint32(p, stats->count ? (uint32_t)(stats->total / stats->count) : 0);
+  }
+  return p - buffer;
+}
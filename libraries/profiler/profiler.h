@@ -0,0 +1,97 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ *  Execution time probes of the main loop hot path.
+ *
+ *  Probes count CPU cycles with DWT CYCCNT on target and with the monotonic
+ *  clock scaled to PROFILER_CORE_CLOCK_HZ in the host build, so numbers from
+ *  both are in the same unit. Each probe keeps count, min, max and total cycles.
+ *  CYCCNT stops while the CPU sleeps, probes measure awake time only.
+ *
+ *  Usage:
+ *    PROFILER_BEGIN(PROFILER_MAIN_SENSOR_TASK);
+ *    ...
+ *    PROFILER_END(PROFILER_MAIN_SENSOR_TASK);
+ *
+ *  Define PROFILER_ENABLED 0 to compile the probes out.
+ */
+#ifndef PROFILER_ENABLED
+  #define PROFILER_ENABLED 1
+#endif
+
+#define PROFILER_CORE_CLOCK_HZ   64000000u
+#define PROFILER_FORMAT_VERSION  1
+#define PROFILER_HEADER_LENGTH   6
+#define PROFILER_RECORD_LENGTH   16
+
+typedef enum {
+  PROFILER_MAIN_SENSOR_TASK = 0,
+  PROFILER_BME280_READ_MEASUREMENTS,
+  PROFILER_LIS2DH12_READ_SAMPLES,
+  PROFILER_ENCODE_SW_RAW_FORMAT_5,
+  PROFILER_SET_MANUFACTURER_DATA,
+  PROFILER_BLE_ADVDATA_SET,
+  PROFILER_PROBES
+}profiler_probe_t;
+
+/** Serialized table length, fits NFC data record and a few BLE bulk chunks **/
+#define PROFILER_SERIALIZED_LENGTH (PROFILER_HEADER_LENGTH + PROFILER_PROBES * PROFILER_RECORD_LENGTH)
+
+typedef struct{
+  uint32_t count;
+  uint32_t min;
+  uint32_t max;
+  uint64_t total;
+}profiler_stats_t;
+
+#ifdef HOST_BUILD
+  uint32_t profiler_cycles(void);
+#else
+  #include "nrf.h"
+  static inline uint32_t profiler_cycles(void)
+  {
+    return DWT->CYCCNT;
+  }
+#endif
+
+#if PROFILER_ENABLED
+  #define PROFILER_BEGIN(probe) const uint32_t profiler_start_##probe = profiler_cycles()
+  #define PROFILER_END(probe)   profiler_record((probe), profiler_cycles() - profiler_start_##probe)
+#else
+  #define PROFILER_BEGIN(probe)
+  #define PROFILER_END(probe)
+#endif
+
+/**
+ *  Starts cycle counter and clears statistics.
+ */
+void profiler_init(void);
+
+/**
+ *  Clears statistics of all probes.
+ */
+void profiler_reset(void);
+
+/**
+ *  Adds one measurement of given number of cycles to probe. Called by PROFILER_END.
+ */
+void profiler_record(profiler_probe_t probe, uint32_t cycles);
+
+/**
+ *  Returns statistics of probe, NULL if probe is invalid.
+ */
+const profiler_stats_t* profiler_stats_get(profiler_probe_t probe);
+
+/**
+ *  Serializes statistics to buffer for NFC or BLE transfer. Little endian:
+ *  version (u8), number of probes (u8), core clock in Hz (u32), and for each
+ *  probe in profiler_probe_t order count, min, max and mean cycles (u32 each).
+ *
+ *  Returns number of bytes written, 0 if buffer is shorter than PROFILER_SERIALIZED_LENGTH.
+ */
+size_t profiler_serialize(uint8_t* buffer, size_t length);
+
+#endif
@@ -37,6 +37,18 @@ static message_handler_state_t m_states[NUM_CHAIN_CHANNELS];
 static message_handler_state_t* p_state = NULL;
 static uint8_t m_chain_index = 0;
 
+/** Release DSP windows of current channel, e.g. after any of its states failed to initialize **/
+static void release_dsp(void)
+{
+  for(size_t ii = 0; ii < MAX_DSP_STATES; ii++)
+  {
+    if(dsp_is_init(&(p_state->dsp[ii])))
+    {
+      dsp_uninit(&(p_state->dsp[ii]));
+    }
+  }
+}
+
 //TODO: Deduplicate
 static ret_code_t set_dsp(uint8_t dsp_function, uint8_t dsp_parameter)
 {
@@ -44,27 +56,55 @@ static ret_code_t set_dsp(uint8_t dsp_function, uint8_t dsp_parameter)
   switch(dsp_function)
   {
     case DSP_LAST:
+      release_dsp();
       p_state->configuration.dsp_function  = DSP_LAST;
       p_state->configuration.dsp_parameter = 1; //TODO: Store n last samples?
       status = ENDPOINT_SUCCESS; 
       break;
+    case DSP_MIN:
+    case DSP_MAX:
+    case DSP_AVERAGE:
     case DSP_STDEV:
-      NRF_LOG_INFO("Setting up STDEV filtering for chain %d, parameter %d\r\n", m_chain_index, dsp_parameter);
-      p_state->configuration.dsp_function = DSP_STDEV;
+    case DSP_IMPULSE:
+    case DSP_LOW_PASS:
+    case DSP_HIGH_PASS:
+      NRF_LOG_INFO("Setting up DSP %d for chain %d, parameter %d\r\n", dsp_function, m_chain_index, dsp_parameter);
+      p_state->configuration.dsp_function = dsp_function;
       p_state->configuration.dsp_parameter = dsp_parameter;
+      status = ENDPOINT_SUCCESS;
+      release_dsp();
       for(size_t ii = 0; ii < MAX_DSP_STATES; ii++)
       {
-        if(dsp_is_init(&(p_state->dsp[ii])))
-        {
-          dsp_uninit(&(p_state->dsp[ii]));
-        }
         p_state->dsp[ii] = dsp_init(dsp_function, dsp_parameter);
+        // Window pool exhausted or parameter out of range
+        if(!dsp_is_init(&(p_state->dsp[ii]))) { status = ENDPOINT_INVALID; }
+      }
+      break;
+
+    case DSP_SPECTRUM:
+      NRF_LOG_INFO("Setting up spectrum for chain %d, base bin %d\r\n", m_chain_index, dsp_parameter);
+      p_state->configuration.dsp_function = dsp_function;
+      p_state->configuration.dsp_parameter = dsp_parameter;
+      status = ENDPOINT_SUCCESS;
+      // Channel ii is the amplitude at harmonic ii + 1 of the base bin
+      release_dsp();
+      for(size_t ii = 0; ii < MAX_DSP_STATES; ii++)
+      {
+        p_state->dsp[ii] = dsp_init(dsp_function, dsp_parameter * (ii + 1));
+        if(!dsp_is_init(&(p_state->dsp[ii]))) { status = ENDPOINT_INVALID; }
       }
       break;
 
     default: 
       break;
   }
+  // Rejected configuration does not keep pool windows, channel has no DSP until reconfigured
+  if(ENDPOINT_INVALID == status)
+  {
+    release_dsp();
+    p_state->configuration.dsp_function  = DSP_LAST;
+    p_state->configuration.dsp_parameter = 1;
+  }
   return status;
 }
 
@@ -224,9 +264,11 @@ static ret_code_t read_value_i16(const ruuvi_standard_message_t message)
   {
     NRF_LOG_DEBUG("Processing DSP CH %d\r\n", ii);
     dsp_filter_t* p_filter = &(p_state->dsp[ii]);
-    float next = p_filter->read(&(p_filter->z), p_filter->dsp_parameter);
-    //TODO: Check under/overflows
-    values[ii] = (int16_t)next; 
+    int32_t next = dsp_is_init(p_filter) ? p_filter->read(&(p_filter->z), p_filter->dsp_parameter) : 0;
+    // Saturate, i.e. high pass of full scale step exceeds int16
+    if(next > INT16_MAX)      { next = INT16_MAX; }
+    else if(next < INT16_MIN) { next = INT16_MIN; }
+    values[ii] = (int16_t)next;
   }
 
   ruuvi_standard_message_t reply = {.destination_endpoint = message.destination_endpoint,
@@ -281,12 +323,14 @@ static ret_code_t process_i16(const ruuvi_standard_message_t message)
 {
   int16_t values[4];
   memcpy(values, message.payload, sizeof(message.payload));
+  bool spectrum = (DSP_SPECTRUM == p_state->configuration.dsp_function);
   for(size_t ii = 0; ii < 4; ii++)
   {
     NRF_LOG_DEBUG("Processing DSP CH %d\r\n", ii);
-    float next = (float) values[ii];
     dsp_filter_t* p_filter = &(p_state->dsp[ii]);
-    NRF_LOG_DEBUG("Filter is init: %d, parameter is %d, next value is %d \r\n", dsp_is_init(p_filter), p_filter->dsp_parameter, values[ii]);
+    int16_t next = spectrum ? values[CHAIN_SPECTRUM_CHANNEL] : values[ii];
+    NRF_LOG_DEBUG("Filter is init: %d, parameter is %d, next value is %d \r\n", dsp_is_init(p_filter), p_filter->dsp_parameter, next);
+    if(!dsp_is_init(p_filter)) { continue; }
     p_filter->process(&(p_filter->z), p_filter->dsp_parameter, next);
   }
   //If we were configured to transmit each sample, trigger transmission now
@@ -298,22 +342,59 @@ static ret_code_t process_i16(const ruuvi_standard_message_t message)
   return NRF_SUCCESS;
 }
 
+/** Select chain channel by endpoint, return false if endpoint is not a chain channel **/
+static bool select_chain(const uint8_t endpoint)
+{
+  if (endpoint <  ENDPOINT_CHAIN_OFFSET ||
+      endpoint >= ENDPOINT_CHAIN_OFFSET + NUM_CHAIN_CHANNELS)
+  {
+    return false;
+  }
+  m_chain_index = endpoint - ENDPOINT_CHAIN_OFFSET;
+  p_state = &(m_states[m_chain_index]);
+  return true;
+}
+
+/**
+ *  Handles a batch of INT16 samples, i.e. accelerometer FIFO.
+ *  Each axis is run through its DSP in one call, unless every sample is transmitted onwards.
+ */
+ret_code_t chain_block_handler(const uint8_t destination_endpoint, const int16_t* samples, const size_t count)
+{
+  if(!select_chain(destination_endpoint)) { return ENDPOINT_INVALID; }
+  NRF_LOG_DEBUG("Received block of %d samples to chain %d\r\n", count, m_chain_index);
+  if(TRANSMISSION_RATE_SAMPLERATE == p_state->configuration.transmission_rate)
+  {
+    ret_code_t err_code = ENDPOINT_SUCCESS;
+    ruuvi_standard_message_t message = {.destination_endpoint = destination_endpoint,
+                                        .source_endpoint = ACCELERATION,
+                                        .type = INT16,
+                                        .payload = { 0 }};
+    for(size_t ii = 0; ii < count; ii++)
+    {
+      memcpy(message.payload, &samples[ii * CHAIN_BLOCK_CHANNELS], sizeof(message.payload));
+      err_code |= process_i16(message);
+    }
+    return err_code;
+  }
+  bool spectrum = (DSP_SPECTRUM == p_state->configuration.dsp_function);
+  for(size_t ii = 0; ii < MAX_DSP_STATES; ii++)
+  {
+    size_t channel = spectrum ? CHAIN_SPECTRUM_CHANNEL : ii;
+    dsp_process_block(&(p_state->dsp[ii]), samples + channel, count, CHAIN_BLOCK_CHANNELS);
+  }
+  return ENDPOINT_SUCCESS;
+}
+
 /**
  *  Handles incoming messages.
  */
 ret_code_t chain_handler(const ruuvi_standard_message_t message)
 {
   //Return if the message was not targeted to chain channel, i.e. data query replies
-  if (message.destination_endpoint <  ENDPOINT_CHAIN_OFFSET ||
-      message.destination_endpoint >= ENDPOINT_CHAIN_OFFSET + NUM_CHAIN_CHANNELS)
-  {
-    return ENDPOINT_INVALID;
-  }
-  // Get index of target chain
-  m_chain_index = message.destination_endpoint - ENDPOINT_CHAIN_OFFSET;
-  NRF_LOG_DEBUG("Received Chain message to chain %d\r\n", m_chain_index);
   //Store pointer to state of selected chain channel
-  p_state = &(m_states[m_chain_index]);
+  if(!select_chain(message.destination_endpoint)) { return ENDPOINT_INVALID; }
+  NRF_LOG_DEBUG("Received Chain message to chain %d\r\n", m_chain_index);
   switch(message.type)
   {
     case SENSOR_CONFIGURATION:
@@ -3,11 +3,24 @@
 
 #define NUM_CHAIN_CHANNELS 16
 #define ENDPOINT_CHAIN_OFFSET 0x50
+// Interleaved values per sample in blocks, as in INT16 payload
+#define CHAIN_BLOCK_CHANNELS 4
+
+/**
+ *  Chain with DSP_SPECTRUM runs all four DSP states on the magnitude channel, which does not
+ *  depend on mounting orientation, and transmits the amplitudes at harmonics 1 ... 4 of base bin
+ *  dsp_parameter as its four values. Bins are of 64 sample blocks, i.e. 6.25 Hz at 400 Hz,
+ *  so base bin is 1 ... 7. Eight bytes of band amplitudes replace the raw samples.
+ */
+#define CHAIN_SPECTRUM_CHANNEL 3
 
 #include "ruuvi_endpoints.h"
 
 ret_code_t chain_handler(const ruuvi_standard_message_t message);
 
+// Processes count samples of CHAIN_BLOCK_CHANNELS interleaved int16 values, see block_handler
+ret_code_t chain_block_handler(const uint8_t destination_endpoint, const int16_t* samples, const size_t count);
+
 //Initializes application timers, required for transmitting data
 ret_code_t chain_handler_init(void);
 
@@ -18,9 +18,12 @@ static message_handler p_magnetometer_handler      = NULL;
 static message_handler p_gyroscope_handler         = NULL;
 static message_handler p_movement_detector_handler = NULL;
 static message_handler p_mam_handler               = NULL;
+static message_handler p_profiler_handler          = NULL;
+static message_handler p_trace_handler             = NULL;
 
 /** Chain handler **/
 static message_handler p_chain_handler = NULL;
+static block_handler p_chain_block_handler = NULL;
 
 /** Data traffic handlers **/
 static message_handler p_reply_handler       = NULL;
@@ -114,6 +117,16 @@ void route_message(const ruuvi_standard_message_t message)
         if(p_mam_handler) {p_mam_handler(message); } 
         else {unknown_handler(message); }
         break;
+
+      case PROFILER:
+        if(p_profiler_handler) {p_profiler_handler(message); } 
+        else {unknown_handler(message); }
+        break;
+
+      case EVENT_TRACE:
+        if(p_trace_handler) {p_trace_handler(message); } 
+        else {unknown_handler(message); }
+        break;
     
       default:
         //Call chain handler if applicable
@@ -141,11 +154,26 @@ void set_acceleration_handler(message_handler handler)
   p_acceleration_handler = handler;
 }
 
+void set_movement_detector_handler(message_handler handler)
+{
+  p_movement_detector_handler = handler;
+}
+
 void set_mam_handler(message_handler handler)
 {
   p_mam_handler = handler;
 }
 
+void set_profiler_handler(message_handler handler)
+{
+  p_profiler_handler = handler;
+}
+
+void set_trace_handler(message_handler handler)
+{
+  p_trace_handler = handler;
+}
+
 void set_reply_handler(message_handler handler)
 {
   p_reply_handler = handler;
@@ -191,6 +219,11 @@ void set_chain_handler(message_handler handler)
   p_chain_handler = handler;
 }
 
+void set_chain_block_handler(block_handler handler)
+{
+  p_chain_block_handler = handler;
+}
+
 message_handler get_reply_handler(void)
 {
   return p_reply_handler;
@@ -236,6 +269,11 @@ message_handler get_chain_handler(void)
   return p_chain_handler;
 }
 
+block_handler get_chain_block_handler(void)
+{
+  return p_chain_block_handler;
+}
+
 // Send payload back to source with type "UNKNOWN"
 ret_code_t unknown_handler(const ruuvi_standard_message_t message)
 {
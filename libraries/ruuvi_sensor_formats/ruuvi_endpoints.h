@@ -22,9 +22,11 @@ typedef enum{
   ACCELERATION            = 0x40,
   MAGNETOMETER            = 0x41,
   GYROSCOPE               = 0x42,
-  MOVEMENT_DETECTOR       = 0x43, 
+  MOVEMENT_DETECTOR       = 0x43, // Acceleration event records, see lis2dh12_capture.h
   // endpoints 0x50 ... 0x5F are reserved for chain handlers, however they're not enumerated but rather called dynamically
-  MAM                     = 0xE0  // Masked Authenticated Messaging
+  MAM                     = 0xE0, // Masked Authenticated Messaging
+  PROFILER                = 0xF0, // Execution time statistics, see profiler.h
+  EVENT_TRACE             = 0xF1  // Scheduler and interrupt event trace, see trace.h
 }ruuvi_endpoint_t;
 
 typedef enum{
@@ -90,6 +92,7 @@ typedef enum {
   DSP_IMPULSE   = 6,
   DSP_LOW_PASS  = 7,
   DSP_HIGH_PASS = 8,
+  DSP_SPECTRUM  = 9,   // Vibration amplitude at harmonics of a base frequency, see chain_channels.h
   DSP_VECTOR    = 128
 }ruuvi_dsp_function_t;
 
@@ -137,6 +140,8 @@ typedef struct __attribute__((packed)){
  *  ACCELERATION will transmit *AFTER* its own dsp function the samples to chained channel. The samples are sent at sample
  *  rate of master channel.
  *  Chained channel will transmit the samples to next chained channel after DSP, and to data handlers at a rate given by transmit speed.
+ *  Windowed DSP functions take their windows from a shared pool of DSP_POOL_WORDS samples, see dsp.h.
+ *  Configuration is rejected with ENDPOINT_INVALID if the pool has no room, and the channel is left without DSP.
  */
 typedef struct __attribute__((packed)){
   uint8_t upstream_endpoint;
@@ -159,6 +164,10 @@ typedef struct __attribute__((packed)){
 // Declare message handler type
 typedef ret_code_t(*message_handler)(const ruuvi_standard_message_t);
 
+// Block handler receives count INT16 samples of 4 interleaved values, as in INT16 message payload.
+// Used to pass a sensor FIFO batch to destination endpoint in one call.
+typedef ret_code_t(*block_handler)(const uint8_t destination_endpoint, const int16_t* samples, const size_t count);
+
 /** Message handler state **/
 typedef struct {
 /** Data target handlers **/
@@ -172,6 +181,7 @@ typedef struct {
 
 /** Chain downstream **/
   message_handler p_chain_handler;
+  block_handler p_chain_block_handler;
   uint8_t downstream_endpoint; // Use UINT8_t to allow dynamic endpoint selection
 
 /** State variables **/
@@ -190,7 +200,10 @@ ret_code_t unknown_handler(const ruuvi_standard_message_t message);
 // Peripheral handlers
 void set_temperature_handler(message_handler handler);
 void set_acceleration_handler(message_handler handler);
+void set_movement_detector_handler(message_handler handler);
 void set_mam_handler(message_handler handler);
+void set_profiler_handler(message_handler handler);
+void set_trace_handler(message_handler handler);
 void set_unknown_handler(message_handler handler);
 
 // Data transmission handlers
@@ -202,6 +215,7 @@ void set_reply_handler(message_handler handler);
 void set_ram_handler(message_handler handler);
 void set_flash_handler(message_handler handler);
 void set_chain_handler(message_handler handler);
+void set_chain_block_handler(block_handler handler);
 
 message_handler get_reply_handler(void);
 message_handler get_ble_adv_handler(void);
@@ -212,5 +226,6 @@ message_handler get_nfc_handler(void);
 message_handler get_ram_handler(void);
 message_handler get_flash_handler(void);
 message_handler get_chain_handler(void);
+block_handler get_chain_block_handler(void);
 
 #endif
@@ -4,10 +4,12 @@
 #include "sensortag.h"
 
 #include <stdint.h>
+#include <string.h>
 #include "nrf52.h"
 #include "nrf52_bitfields.h"
 
 #include "base64.h"
+#include "profiler.h"
 
 #define NRF_LOG_MODULE_NAME "SENSORLIB"
 #include "nrf_log.h"
@@ -82,6 +84,7 @@ void encodeToRawFormat5(uint8_t* data_buffer, const ruuvi_sensor_t* const data,
  */
 void encodeToSWRawFormat5(uint8_t* data_buffer, const ruuvi_sensor_t* const data, uint16_t acceleration_events, int8_t tx_pwr, bool sw)
 {
+    PROFILER_BEGIN(PROFILER_ENCODE_SW_RAW_FORMAT_5);
     static uint32_t packet_counter = 0;
     if(sw){data_buffer[0] = SW_DOOR_OPEN;}
     else{data_buffer[0] = SW_DOOR_CLOSED;}
@@ -126,7 +129,25 @@ void encodeToSWRawFormat5(uint8_t* data_buffer, const ruuvi_sensor_t* const data
     data_buffer[21] = ((NRF_FICR->DEVICEADDR[0]>>16)&0xFF);
     data_buffer[22] = ((NRF_FICR->DEVICEADDR[0]>>8)&0xFF);
     data_buffer[23] = ((NRF_FICR->DEVICEADDR[0]>>0)&0xFF);
+    PROFILER_END(PROFILER_ENCODE_SW_RAW_FORMAT_5);
+}
 
+/**
+ *  Parses sensor values into SW format with door events, shares packet counter with SW format.
+ *
+ *  @param knock_events counter of knocks detected by accelerometer
+ *  @param angle door opening angle in 0.1 degrees, negative if unknown
+ *  @param sw state, if true door is open
+ */
+void encodeToSWv2Format(uint8_t* data_buffer, const ruuvi_sensor_t* const data, uint16_t acceleration_events, uint16_t knock_events, int16_t angle, int8_t tx_pwr, bool sw)
+{
+    encodeToSWRawFormat5(data_buffer, data, acceleration_events, tx_pwr, sw);
+    if(sw){data_buffer[0] = SW2_DOOR_OPEN;}
+    else{data_buffer[0] = SW2_DOOR_CLOSED;}
+    data_buffer[18] = knock_events % 256; // 0 may indicate a multiple of 256 knocks, not necessarily no knocks
+    if(angle < 0 || angle > 1800) { data_buffer[19] = SW2_ANGLE_INVALID; }
+    else { data_buffer[19] = (angle + 5) / 10; } // Round to degrees
+    memset(&data_buffer[20], 0, 4);
 }
 
 /**
@@ -23,6 +23,8 @@
 #define RAW_FORMAT_2                    0x05          /**< Proposal, please see https://f.ruuvi.com/t/proposed-next-high-precision-data-format/692 */
 #define SW_DOOR_CLOSED                  0x15          /**< Variation of RAWv2, 15 is door closed */
 #define SW_DOOR_OPEN                    0x16          /**< Variation of RAWv2, 16 is door open */ 
+#define SW2_DOOR_CLOSED                 0x17          /**< Variation of SW format with door events in place of MAC, 17 is door closed */
+#define SW2_DOOR_OPEN                   0x18          /**< Variation of SW format with door events in place of MAC, 18 is door open */
 #define RAW_2_ENCODED_DATA_LENGTH       24
 
 #define WEATHER_STATION_URL_FORMAT      0x02				  /**< Base64 */
@@ -42,6 +44,7 @@
 #define RAW2_HUMIDITY_INVALID     HUMIDITY_INVALID
 #define RAW2_PRESSURE_INVALID     PRESSURE_INVALID
 #define RAW2_ACCELERATION_INVALID ACCELERATION_INVALID
+#define SW2_ANGLE_INVALID         0xFF
 #define RAW1_TEMPERATURE_INVALID  0
 #define RAW1_HUMIDITY_INVALID     0
 #define RAW1_PRESSURE_INVALID     0
@@ -93,6 +96,20 @@ void encodeToRawFormat5(uint8_t* data_buffer,  const ruuvi_sensor_t* const data,
  */
 void encodeToSWRawFormat5(uint8_t* data_buffer,  const ruuvi_sensor_t* const data, uint16_t acceleration_events, int8_t tx_pwr, bool sw);
 
+/**
+ *  SW format with door events. Bytes 1-17 are as in SW format. MAC address is also the
+ *  advertiser address, its bytes carry door events instead:
+ *  18:    uint8_t knock counter, modulo 256
+ *  19:    uint8_t door opening angle in degrees, 0 ... 180, SW2_ANGLE_INVALID if unknown
+ *  20-23: reserved, 0
+ *
+ *  @param data_buffer uint8_t array with length of 24 bytes
+ *  @param knock_events counter of knocks detected by accelerometer
+ *  @param angle door opening angle in 0.1 degrees, negative if unknown
+ *  @param sw, if true door is open
+ */
+void encodeToSWv2Format(uint8_t* data_buffer,  const ruuvi_sensor_t* const data, uint16_t acceleration_events, uint16_t knock_events, int16_t angle, int8_t tx_pwr, bool sw);
+
 
 /**
  *  Encodes sensor data into given char* url. The base url must have the base of url written by caller.
@@ -0,0 +1,55 @@
+#include "trace.h"
+#include <string.h>
+#include "rtc.h"
+
+static trace_record_t m_records[TRACE_BUFFER_LENGTH];
+static volatile uint32_t m_head = 0;  // Events since reset, next record is m_head % TRACE_BUFFER_LENGTH
+
+void trace_reset(void)
+{
+  memset(m_records, 0, sizeof(m_records));
+  m_head = 0;
+}
+
+void trace_record(trace_event_t event, uint16_t arg)
+{
+  // Claim slot atomically, interrupts may record while main context is recording.
+  uint32_t index = __atomic_fetch_add(&m_head, 1, __ATOMIC_RELAXED);
+  trace_record_t* record = &m_records[index & (TRACE_BUFFER_LENGTH - 1)];
+  record->time  = (uint32_t)millis();
+  record->arg   = arg;
+  record->event = event;
+}
+
+uint32_t trace_count(void)
+{
+  return m_head;
+}
+
+size_t trace_serialize(uint8_t* buffer, size_t length)
+{
+  if(NULL == buffer || TRACE_SERIALIZED_LENGTH > length) { return 0; }
+  uint32_t head = m_head;
+  uint32_t count = (head < TRACE_BUFFER_LENGTH) ? head : TRACE_BUFFER_LENGTH;
+  uint8_t* p = buffer;
+  *p++ = TRACE_FORMAT_VERSION;
+  *p++ = TRACE_RECORD_LENGTH;
+  *p++ = count;
+  *p++ = count >> 8;
+  *p++ = head;
+  *p++ = head >> 8;
+  *p++ = head >> 16;
+  *p++ = head >> 24;
+  for(uint32_t ii = head - count; ii != head; ii++)
+  {
+    const trace_record_t* record = &m_records[ii & (TRACE_BUFFER_LENGTH - 1)];
+    *p++ = record->time;
+    *p++ = record->time >> 8;
+    *p++ = record->time >> 16;
+    *p++ = record->time >> 24;
+    *p++ = record->event;
+    *p++ = record->arg;
+    *p++ = record->arg >> 8;
+  }
+  return p - buffer;
+}
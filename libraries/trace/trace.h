@@ -0,0 +1,91 @@
+#ifndef TRACE_H
+#define TRACE_H
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ *  Binary event trace of scheduler and interrupt activity.
+ *
+ *  Each event is stored as millis() timestamp, event id and 16-bit argument
+ *  into a fixed RAM ring which overwrites the oldest events. Recording is a
+ *  few stores and safe from interrupt context, so the trace can be left on
+ *  in production where NRF_LOG output would be too expensive.
+ *
+ *  The ring is read out with trace_serialize() and decoded into a timeline
+ *  by host/trace_decode.
+ *
+ *  Define TRACE_ENABLED 0 to compile the events out.
+ */
+#ifndef TRACE_ENABLED
+  #define TRACE_ENABLED 1
+#endif
+
+/** Number of events kept, power of two **/
+#ifndef TRACE_BUFFER_LENGTH
+  #define TRACE_BUFFER_LENGTH 128
+#endif
+
+#if (TRACE_BUFFER_LENGTH & (TRACE_BUFFER_LENGTH - 1))
+  #error "TRACE_BUFFER_LENGTH must be a power of two"
+#endif
+
+#define TRACE_FORMAT_VERSION  1
+#define TRACE_HEADER_LENGTH   8
+#define TRACE_RECORD_LENGTH   7
+
+/** Serialized ring length, fits a BLE bulk transfer **/
+#define TRACE_SERIALIZED_LENGTH (TRACE_HEADER_LENGTH + TRACE_BUFFER_LENGTH * TRACE_RECORD_LENGTH)
+
+/** Function addresses are stored in 16 bits, 8-byte resolution covers 512 kB of flash **/
+#define TRACE_ADDRESS_SHIFT 3
+#define TRACE_ADDRESS(p) ((uint16_t)((uintptr_t)(p) >> TRACE_ADDRESS_SHIFT))
+
+typedef enum {
+  TRACE_SCHED_PUT = 1,    // arg: TRACE_ADDRESS of handler
+  TRACE_SCHED_PUT_FAILED, // arg: TRACE_ADDRESS of handler, queue full or event too large
+  TRACE_SCHED_DISPATCH,   // arg: TRACE_ADDRESS of handler
+  TRACE_PIN,              // arg: pin number, pin level in bit 8
+  TRACE_RADIO,            // arg: 1 if radio becomes active, 0 if radio was turned off
+  TRACE_SPI_START,        // arg: chip select pin in high byte, bytes to transfer in low byte
+  TRACE_SPI_STOP,         // arg: as TRACE_SPI_START
+  TRACE_EVENTS
+}trace_event_t;
+
+typedef struct{
+  uint32_t time;  // millis(), wraps after 49 days
+  uint16_t arg;
+  uint8_t  event;
+}trace_record_t;
+
+#if TRACE_ENABLED
+  #define TRACE_EVENT(event, arg) trace_record((event), (arg))
+#else
+  #define TRACE_EVENT(event, arg)
+#endif
+
+/**
+ *  Clears the ring.
+ */
+void trace_reset(void);
+
+/**
+ *  Adds event to ring. Called by TRACE_EVENT, safe in interrupt context.
+ */
+void trace_record(trace_event_t event, uint16_t arg);
+
+/**
+ *  Returns number of events recorded since reset, including overwritten ones.
+ */
+uint32_t trace_count(void);
+
+/**
+ *  Serializes ring to buffer for BLE transfer. Little endian:
+ *  version (u8), record length (u8), number of records (u16), events since reset (u32),
+ *  and records from oldest to newest as time (u32), event (u8), arg (u16).
+ *  Events recorded by interrupts during serialization may appear out of order.
+ *
+ *  Returns number of bytes written, 0 if buffer is shorter than TRACE_SERIALIZED_LENGTH.
+ */
+size_t trace_serialize(uint8_t* buffer, size_t length);
+
+#endif
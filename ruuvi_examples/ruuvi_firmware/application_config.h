@@ -24,6 +24,11 @@
 #define BME280_IIR                      BME280_IIR_16
 #define BME280_DELAY                    BME280_STANDBY_1000_MS
 
+// Forced mode: one conversion per main loop, read when ready and low passed in software.
+// BME280_IIR and BME280_DELAY apply to normal mode only.
+#define APPLICATION_BME280_FORCED_ENABLED 1
+#define BME280_SOFTWARE_IIR             BME280_IIR_16
+
 #define LIS2DH12_SCALE              LIS2DH12_SCALE2G
 #define LIS2DH12_RESOLUTION         LIS2DH12_RES10BIT
 #define LIS2DH12_SAMPLERATE_RAWv2   LIS2DH12_RATE_10
@@ -32,4 +37,73 @@
 // mg, scaled to bits by driver
 #define LIS2DH12_ACTIVITY_THRESHOLD 64
 
+// Record acceleration before and after activity interrupt, see lis2dh12_capture.h.
+// Capture runs accelerometer at LIS2DH12_SAMPLERATE_CAPTURE instead of RAWv1 rate all the time,
+// 32 samples on each side of the event span 0.32 s at 100 Hz. Accelerometer draws about 20 uA
+// at 100 Hz against 2 uA at 1 Hz, see host/energy_sim. Opt-in, can also be armed over GATT.
+#define APPLICATION_CAPTURE_ENABLED 0
+#define LIS2DH12_SAMPLERATE_CAPTURE LIS2DH12_RATE_100
+
+// Sleep-to-wake drops accelerometer to low-power mode while door is still, see lis2dh12_set_sleep_to_wake.
+// Sensor sleeps at fixed 10 Hz, which saves current only when configured rate is above 10 Hz.
+// Capture records would mix 10 Hz samples into a fixed-rate record, capture must be disabled and is refused over GATT.
+// Main sensor task skips accelerometer read while sensor sleeps. Activity interrupt moves to INT1 pin.
+#define APPLICATION_SLEEP_TO_WAKE_ENABLED 1
+// mg, acceleration above threshold wakes sensor
+#define LIS2DH12_INACTIVITY_THRESHOLD     64
+// ms below threshold before sensor sleeps
+#define LIS2DH12_INACTIVITY_DURATION      5000
+
+// SW2 advertisement format 0x17 / 0x18 carries knock counter and door angle in bytes 18 ... 23,
+// which overwrite the MAC address of SW format 0x15 / 0x16. Receivers must take MAC from advertiser address.
+#define APPLICATION_SW2_FORMAT_ENABLED    0
+
+// Knock detection with LIS2DH12 click interrupt on INT1 pin, counted in SW2 advertisement format.
+// Knock is advertised at ADVERTISING_INTERVAL_KNOCK for ADVERTISING_KNOCK_PERIOD.
+// Sleeping sensor samples too slowly for click timing and both need a pin, sleep-to-wake must be disabled.
+// Accelerometer stays at LIS2DH12_SAMPLERATE_KNOCK also when capture is stopped, about 20 uA
+// at 100 Hz against 2 uA at 1 Hz, see host/energy_sim. Opt-in.
+#define APPLICATION_KNOCK_ENABLED         0
+// Click timing is counted at this rate, equal to capture rate so it holds whether capture runs or not.
+// Application note recommends 400 Hz, which draws over three times the current of 100 Hz.
+#define LIS2DH12_SAMPLERATE_KNOCK         LIS2DH12_RATE_100
+// LIS2DH12_XD_MASK etc. for double knock, LIS2DH12_XS_MASK etc. for single knock, see lis2dh12_registers.h
+#define LIS2DH12_KNOCK_CLICK_CFG          (LIS2DH12_XD_MASK | LIS2DH12_YD_MASK | LIS2DH12_ZD_MASK)
+// mg, high-passed
+#define LIS2DH12_KNOCK_THRESHOLD          750
+// ms, acceleration must return below threshold within time limit to count as a knock
+#define LIS2DH12_KNOCK_TIME_LIMIT         50
+// ms, dead time after first knock
+#define LIS2DH12_KNOCK_LATENCY            100
+// ms, second knock must start within window after latency
+#define LIS2DH12_KNOCK_WINDOW             400
+
+// Door opening angle from direction of gravity, see lis2dh12_orientation.h. Reported if SW2 advertisement format is enabled.
+// Only hatches, lids and tilting windows change gravity, vertical hinge reads 0 degrees.
+// Opt-in, angle beyond LIS2DH12_DOOR_OPEN_ANGLE changes advertised door state even if reed switch reads closed.
+#define APPLICATION_ORIENTATION_ENABLED   0
+// 0 if reed switch on SW pin is not fitted: door is assumed closed at boot and open state comes from angle.
+// With reed switch, angle beyond LIS2DH12_DOOR_OPEN_ANGLE also reports open, e.g. if switch is stuck closed.
+#define APPLICATION_DOOR_SWITCH_ENABLED   1
+// 0.1 degrees
+#define LIS2DH12_DOOR_OPEN_ANGLE          100
+// Gravity low pass y += (x - y) / 2^n per main loop sample
+#define LIS2DH12_ORIENTATION_LOW_PASS     1
+
+#if !APPLICATION_DOOR_SWITCH_ENABLED && !APPLICATION_ORIENTATION_ENABLED
+  #error "Door state needs reed switch or orientation"
+#endif
+
+#if APPLICATION_KNOCK_ENABLED && APPLICATION_SLEEP_TO_WAKE_ENABLED
+  #error "Knock detection and sleep-to-wake cannot be enabled at the same time"
+#endif
+
+#if APPLICATION_KNOCK_ENABLED && !APPLICATION_SW2_FORMAT_ENABLED
+  #error "Knock counter is advertised in SW2 format only"
+#endif
+
+#if APPLICATION_CAPTURE_ENABLED && APPLICATION_SLEEP_TO_WAKE_ENABLED
+  #error "Capture and sleep-to-wake cannot be enabled at the same time"
+#endif
+
 #endif
\ No newline at end of file
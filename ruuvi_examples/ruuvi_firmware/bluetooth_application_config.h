@@ -16,6 +16,8 @@
 #define ADVERTISING_INTERVAL_RAW_SLOW MAIN_LOOP_INTERVAL_RAW_SLOW
 #define ADVERTISING_STARTUP_PERIOD    5000u // milliseconds app advertises at startup speed.
 #define ADVERTISING_INTERVAL_STARTUP  100u  // Interval of startup advertising
+#define ADVERTISING_KNOCK_PERIOD      3000u // milliseconds app advertises at knock speed after a knock.
+#define ADVERTISING_INTERVAL_KNOCK    100u  // Interval of advertising after a knock
 #define APPLICATION_ADV_INTERVAL      ADVERTISING_INTERVAL_RAW //!< Default value for driver
 
 //Raw v2
@@ -20,6 +20,7 @@
 
 #include <stdbool.h>
 #include <stdint.h>
+#include <stdlib.h>
 #include <math.h>
 
 // Nordic SDK
@@ -46,9 +47,13 @@
 #include "flash.h"
 #include "lis2dh12.h"
 #include "lis2dh12_acceleration_handler.h"
+#include "lis2dh12_capture.h"
+#include "lis2dh12_orientation.h"
+#include "chain_channels.h"
 #include "bme280.h"
 #include "battery.h"
 #include "bluetooth_core.h"
+#include "ble_bulk_transfer.h"
 #include "eddystone.h"
 #include "pin_interrupt.h"
 #include "nfc.h"
@@ -58,7 +63,10 @@
 
 // Libraries
 #include "base64.h"
+#include "ringbuffer.h"
 #include "sensortag.h"
+#include "profiler.h"
+#include "trace.h"
 
 // Init
 #include "init.h"
@@ -72,6 +80,7 @@
 // ID for main loop timer.
 APP_TIMER_DEF(main_timer_id);                 // Creates timer id for our program.
 APP_TIMER_DEF(reset_timer_id);                 // Creates timer id for our program.
+APP_TIMER_DEF(bme280_timer_id);                // Forced BME280 conversion time.
 
 static uint16_t init_status = 0;   // combined status of all initalizations.  Zero when all are complete if no errors occured.
 static uint8_t NFC_message[100];   // NFC message buffer has 4 records, up to 128 bytes each minus some overhead for NFC NDEF data keeping. 
@@ -110,10 +119,35 @@ static uint64_t fast_advertising_start = 0;    // Timestamp of when tag became c
 static uint64_t debounce = 0;                  // Flag for avoiding double presses
 static uint64_t sw_debounce = 0;               // Flag for avoiding accidental read of reed switch
 static uint16_t acceleration_events = 0;       // Number of times accelerometer has triggered
-static volatile uint16_t vbat = 0;             // Update in interrupt after radio activity.
+static uint16_t knock_events = 0;              // Number of knocks detected by accelerometer
+static bool knock_advertising = false;         // Advertising at knock interval
+static uint64_t knock_advertising_start = 0;   // Timestamp of latest knock
+static bool bme280_measurement_ready = false;  // Forced conversion done and not read yet
+static uint32_t bme280_measurement_ms = 0;     // Forced conversion time
+static volatile uint16_t vbat = 0;             // Update in main loop after radio activity.
 static uint64_t last_battery_measurement = 0;  // Timestamp of VBat update.
+RINGBUFFER_SPSC_DEF(radio_events, bool, 8);    // Radio notifications, handled in main loop.
 static volatile bool pressed = false;          // Debounce flag
 static volatile bool open = false;             // True if door is open
+static bool accelerometer_inactive = false;    // LIS2DH12 sleeps in low-power mode, see lis2dh12_set_sleep_to_wake
+static lis2dh12_sensor_buffer_t acceleration;  // Latest accelerometer sample
+static bool acceleration_valid = false;        // Acceleration has been read at least once
+
+// Activity interrupt moves to INT1 when INT2 signals inactivity, ACC_ACTIVITY_INT is LIS2DH12 pin number
+#if APPLICATION_SLEEP_TO_WAKE_ENABLED
+  #define ACC_ACTIVITY_PIN INT_ACC1_PIN
+  #define ACC_ACTIVITY_INT 1
+#else
+  #define ACC_ACTIVITY_PIN INT_ACC2_PIN
+  #define ACC_ACTIVITY_INT 2
+#endif
+
+// Sample rate while capture is stopped, knock timing is counted at configured rate
+#if APPLICATION_KNOCK_ENABLED
+  #define ACC_IDLE_SAMPLERATE LIS2DH12_SAMPLERATE_KNOCK
+#else
+  #define ACC_IDLE_SAMPLERATE LIS2DH12_SAMPLERATE_RAWv1
+#endif
 
 // Possible types of switch
 #define NO 0
@@ -267,7 +301,14 @@ ret_code_t sw_handler(const ruuvi_standard_message_t message)
  */
 static void reinit_nfc(void* data, uint16_t length)
 {
+#if PROFILER_ENABLED
+  // Next read shows execution time statistics in data record.
+  static uint8_t profile[PROFILER_SERIALIZED_LENGTH];
+  size_t profile_length = profiler_serialize(profile, sizeof(profile));
+  nfc_init(profile, profile_length);
+#else
   init_nfc();
+#endif
 }
 
 /**@brief Function for handling NFC events.
@@ -345,8 +386,39 @@ void switch_check(void){
   return;
 }
 
+#if APPLICATION_ORIENTATION_ENABLED
+/**
+ * Update reference of the closed door and return opening angle.
+ * With reed switch, reference follows gravity while switch reports closed and angle stays below
+ * LIS2DH12_DOOR_OPEN_ANGLE, so a switch stuck closed does not drag it along.
+ * Without reed switch, door is assumed closed at boot and open state is set from the angle.
+ *
+ * @return angle in 0.1 degrees or LIS2DH12_ORIENTATION_INVALID
+ */
+static int16_t door_angle_update(void)
+{
+  int16_t angle = lis2dh12_orientation_angle();
+#if APPLICATION_DOOR_SWITCH_ENABLED
+  if(!open && angle < LIS2DH12_DOOR_OPEN_ANGLE)
+  {
+    lis2dh12_orientation_set_reference();
+    angle = lis2dh12_orientation_angle();
+  }
+#else
+  if(!lis2dh12_orientation_has_reference())
+  {
+    lis2dh12_orientation_set_reference();
+    angle = lis2dh12_orientation_angle();
+  }
+  if(LIS2DH12_ORIENTATION_INVALID != angle) { open = (angle >= LIS2DH12_DOOR_OPEN_ANGLE); }
+#endif
+  return angle;
+}
+#endif
+
 static void main_sensor_task(void* p_data, uint16_t length)
 {
+  PROFILER_BEGIN(PROFILER_MAIN_SENSOR_TASK);
   // Signal mode by led color.
   if(open){
     RED_LED_ON;
@@ -361,7 +433,6 @@ static void main_sensor_task(void* p_data, uint16_t length)
                           .temperature = TEMPERATURE_INVALID,
                           .vbat = vbat
                         };
-  lis2dh12_sensor_buffer_t buffer;
 
   if (fast_advertising && ((millis() - fast_advertising_start) > ADVERTISING_STARTUP_PERIOD))
   {
@@ -372,10 +443,28 @@ static void main_sensor_task(void* p_data, uint16_t length)
     bluetooth_apply_configuration();
   }
 
+  // Connectable mode advertises fast on its own and restores interval when it ends.
+  if (knock_advertising && !fast_advertising && ((millis() - knock_advertising_start) > ADVERTISING_KNOCK_PERIOD))
+  {
+    knock_advertising = false;
+    bluetooth_configure_advertising_interval(ADVERTISING_INTERVAL_RAW);
+    bluetooth_apply_configuration();
+  }
+
   if (bme280_available)
   {
     // Get raw environmental data.
+#if APPLICATION_BME280_FORCED_ENABLED
+    // Read each forced conversion once, software IIR must see each sample once.
+    // Tasks scheduled between conversions, e.g. by knocks, use previous values.
+    if(bme280_measurement_ready && !bme280_is_measuring())
+    {
+      bme280_read_measurements();
+      bme280_measurement_ready = false;
+    }
+#else
     bme280_read_measurements();
+#endif
     data.temperature = bme280_get_temperature();
     data.pressure    = bme280_get_pressure();
     data.humidity    = bme280_get_humidity();
@@ -390,45 +479,108 @@ static void main_sensor_task(void* p_data, uint16_t length)
   }
 
   if(lis2dh12_available)
+  {
+    // Drain samples following an acceleration event, re-arms capture once the record is full.
+    lis2dh12_capture_process();
+  }
+
+  // Skip SPI read while sensor reports inactivity, door is still and previous sample is current.
+  // FIFO holds the event record while capture is triggered, previous sample is used then too.
+  if(lis2dh12_available && !accelerometer_inactive && LIS2DH12_CAPTURE_TRIGGERED != lis2dh12_capture_state())
   {
     // Get accelerometer data.
-    lis2dh12_read_samples(&buffer, 1);
-    data.accX = buffer.sensor.x;
-    data.accY = buffer.sensor.y;
-    data.accZ = buffer.sensor.z;
+    lis2dh12_read_samples(&acceleration, 1);
+    acceleration_valid = true;
+#if APPLICATION_ORIENTATION_ENABLED
+    lis2dh12_orientation_update(&acceleration.sensor, LIS2DH12_ORIENTATION_LOW_PASS);
+#endif
+  }
+  if(acceleration_valid)
+  {
+    data.accX = acceleration.sensor.x;
+    data.accY = acceleration.sensor.y;
+    data.accZ = acceleration.sensor.z;
   }
 
+#if APPLICATION_DOOR_SWITCH_ENABLED
   if(millis() - sw_debounce > APPLICATION_SWITCH_INTERVAL){
     switch_check();
   }
+#endif
 
-  encodeToSWRawFormat5(data_buffer, &data, acceleration_events, BLE_TX_POWER, open);
+  bool door_open = open;
+  int16_t angle = LIS2DH12_ORIENTATION_INVALID;
+#if APPLICATION_ORIENTATION_ENABLED
+  if(lis2dh12_available)
+  {
+    angle = door_angle_update();
+    // Reed switch stuck closed or missing magnet, door is open by angle.
+    if(angle >= LIS2DH12_DOOR_OPEN_ANGLE) { door_open = true; }
+  }
+#endif
+
+#if APPLICATION_SW2_FORMAT_ENABLED
+  encodeToSWv2Format(data_buffer, &data, acceleration_events, knock_events, angle, BLE_TX_POWER, door_open);
+#else
+  encodeToSWRawFormat5(data_buffer, &data, acceleration_events, BLE_TX_POWER, door_open);
+#endif
 
   updateAdvertisement();
   watchdog_feed();
+  PROFILER_END(PROFILER_MAIN_SENSOR_TASK);
   
 }
 
+#if APPLICATION_BME280_FORCED_ENABLED
+/**@brief Timeout handler for the forced BME280 conversion, runs sensor task once data is ready
+ */
+static void bme280_timer_handler(void * p_context)
+{
+  bme280_measurement_ready = true;
+  app_sched_event_put (NULL, 0, main_sensor_task);
+}
+
+/**
+ * Start forced BME280 conversion, sensor task runs after conversion time.
+ */
+static void bme280_trigger_task(void* p_data, uint16_t length)
+{
+  if(BME280_RET_OK != bme280_set_mode(BME280_MODE_FORCED))
+  {
+    main_sensor_task(NULL, 0);
+    return;
+  }
+  app_timer_start(bme280_timer_id, APP_TIMER_TICKS(bme280_measurement_ms, RUUVITAG_APP_TIMER_PRESCALER), NULL);
+}
+#endif
+
 /**@brief Timeout handler for the repeated timer
  */
 static void main_timer_handler(void * p_context)
 {
+#if APPLICATION_BME280_FORCED_ENABLED
+  if(bme280_available)
+  {
+    app_sched_event_put (NULL, 0, bme280_trigger_task);
+    return;
+  }
+#endif
   app_sched_event_put (NULL, 0, main_sensor_task);
 }
 
 
 /**
- * @brief Handle interrupt from lis2dh12.
- * Never do long actions, such as sensor reads in interrupt context.
- * Using peripherals in interrupt is also risky,
- * as peripherals might require interrupts for their function.
+ * @brief Handle activity interrupt from lis2dh12, on INT1 or INT2 pin depending on APPLICATION_SLEEP_TO_WAKE_ENABLED.
+ * Called from main loop by pin_interrupt_process, interrupt only queues the pin event.
  *
  *  @param message Ruuvi message, with source, destination, type and 8 byte payload. Ignore for now.
  **/
-ret_code_t lis2dh12_int2_handler(const ruuvi_standard_message_t message)
+ret_code_t lis2dh12_activity_handler(const ruuvi_standard_message_t message)
 {
-  NRF_LOG_DEBUG("Accelerometer interrupt to pin 2\r\n");
+  NRF_LOG_DEBUG("Accelerometer activity interrupt\r\n");
   acceleration_events++;
+  // Freeze samples preceding the event, ignored if capture is not armed.
+  lis2dh12_capture_trigger(millis());
   /*
   app_sched_event_put ((void*)(&message),
                        sizeof(message),
@@ -437,19 +589,191 @@ ret_code_t lis2dh12_int2_handler(const ruuvi_standard_message_t message)
   return NRF_SUCCESS;
 }
 
+/**
+ * @brief Handle knock interrupt from lis2dh12 on INT1 pin.
+ * Updates advertisement at once and advertises at knock interval for ADVERTISING_KNOCK_PERIOD.
+ *
+ *  @param message Ruuvi message, with source, destination, type and 8 byte payload. Ignore for now.
+ **/
+ret_code_t lis2dh12_knock_handler(const ruuvi_standard_message_t message)
+{
+  NRF_LOG_DEBUG("Knock\r\n");
+  knock_events++;
+  if(!fast_advertising)
+  {
+    knock_advertising = true;
+    knock_advertising_start = millis();
+    bluetooth_configure_advertising_interval(ADVERTISING_INTERVAL_KNOCK);
+    bluetooth_apply_configuration();
+  }
+  // Publish knock counter without waiting for main timer.
+  app_sched_event_put (NULL, 0, main_sensor_task);
+  return NRF_SUCCESS;
+}
+
+/**
+ * @brief Handle sleep-to-wake status from lis2dh12 on INT2 pin, which is high while the sensor sleeps.
+ * Called from main loop by pin_interrupt_process on both edges.
+ *
+ *  @param message Ruuvi message, payload[1] has pin level.
+ **/
+ret_code_t lis2dh12_sleep_handler(const ruuvi_standard_message_t message)
+{
+  accelerometer_inactive = message.payload[1];
+  NRF_LOG_DEBUG("Accelerometer %s\r\n", (uint32_t)(accelerometer_inactive ? "inactive" : "active"));
+  return NRF_SUCCESS;
+}
+
+/**
+ * @brief Handle messages to profiler endpoint.
+ * LOG_QUERY sends serialized execution time statistics as a bulk transfer,
+ * SENSOR_CONFIGURATION clears the statistics.
+ *
+ *  @param message Ruuvi message, with source, destination, type and 8 byte payload.
+ **/
+ret_code_t profiler_handler(const ruuvi_standard_message_t message)
+{
+  switch(message.type)
+  {
+    case LOG_QUERY:
+    {
+      // Freed by bulk transfer once sent
+      uint8_t* profile = calloc(1, PROFILER_SERIALIZED_LENGTH);
+      if(NULL == profile) { return ENDPOINT_HANDLER_ERROR; }
+      size_t profile_length = profiler_serialize(profile, PROFILER_SERIALIZED_LENGTH);
+      if(ble_bulk_transfer_asynchronous(PROFILER, profile, profile_length))
+      {
+        free(profile);
+        return ENDPOINT_HANDLER_ERROR;
+      }
+      break;
+    }
+
+    case SENSOR_CONFIGURATION:
+      profiler_reset();
+      break;
+
+    default:
+      return ENDPOINT_NOT_SUPPORTED;
+  }
+  return ENDPOINT_SUCCESS;
+}
+
+/**
+ * @brief Handle messages to movement detector endpoint.
+ * LOG_QUERY sends latest acceleration event record as a bulk transfer,
+ * SENSOR_CONFIGURATION with sample rate SAMPLE_RATE_STOP stops capture, other rates restart it
+ * unless sleep-to-wake is enabled.
+ *
+ *  @param message Ruuvi message, with source, destination, type and 8 byte payload.
+ **/
+ret_code_t capture_handler(const ruuvi_standard_message_t message)
+{
+  if(!lis2dh12_available) { return ENDPOINT_NOT_SUPPORTED; }
+  switch(message.type)
+  {
+    case LOG_QUERY:
+    {
+      // Freed by bulk transfer once sent
+      uint8_t* record = calloc(1, LIS2DH12_CAPTURE_SERIALIZED_LENGTH);
+      if(NULL == record) { return ENDPOINT_HANDLER_ERROR; }
+      size_t record_length = lis2dh12_capture_serialize(record, LIS2DH12_CAPTURE_SERIALIZED_LENGTH);
+      if(0 == record_length || ble_bulk_transfer_asynchronous(MOVEMENT_DETECTOR, record, record_length))
+      {
+        free(record);
+        return ENDPOINT_HANDLER_ERROR;
+      }
+      break;
+    }
+
+    case SENSOR_CONFIGURATION:
+    {
+      const ruuvi_sensor_configuration_t* config = (void*)&(message.payload[0]);
+      if(SAMPLE_RATE_STOP == config->sample_rate)
+      {
+        lis2dh12_capture_disarm();
+        lis2dh12_set_sample_rate(ACC_IDLE_SAMPLERATE);
+      }
+      else if(SAMPLE_RATE_NO_CHANGE != config->sample_rate)
+      {
+#if APPLICATION_SLEEP_TO_WAKE_ENABLED
+        // Sleeping sensor would fill record with 10 Hz samples
+        return ENDPOINT_NOT_SUPPORTED;
+#else
+        lis2dh12_capture_arm(LIS2DH12_SAMPLERATE_CAPTURE, ACC_ACTIVITY_INT);
+#endif
+      }
+      break;
+    }
+
+    default:
+      return ENDPOINT_NOT_SUPPORTED;
+  }
+  return ENDPOINT_SUCCESS;
+}
+
+/**
+ * @brief Handle messages to event trace endpoint.
+ * LOG_QUERY sends serialized trace ring as a bulk transfer,
+ * SENSOR_CONFIGURATION clears the ring.
+ *
+ *  @param message Ruuvi message, with source, destination, type and 8 byte payload.
+ **/
+ret_code_t trace_handler(const ruuvi_standard_message_t message)
+{
+  switch(message.type)
+  {
+    case LOG_QUERY:
+    {
+      // Freed by bulk transfer once sent
+      uint8_t* trace = calloc(1, TRACE_SERIALIZED_LENGTH);
+      if(NULL == trace) { return ENDPOINT_HANDLER_ERROR; }
+      size_t trace_length = trace_serialize(trace, TRACE_SERIALIZED_LENGTH);
+      if(ble_bulk_transfer_asynchronous(EVENT_TRACE, trace, trace_length))
+      {
+        free(trace);
+        return ENDPOINT_HANDLER_ERROR;
+      }
+      break;
+    }
+
+    case SENSOR_CONFIGURATION:
+      trace_reset();
+      break;
+
+    default:
+      return ENDPOINT_NOT_SUPPORTED;
+  }
+  return ENDPOINT_SUCCESS;
+}
+
 /**
  * Task to run on radio activity
- * This function is in interrupt context, avoid long processing or using peripherals.
+ * This function is in interrupt context, queue the event for radio_events_process.
  *
  * parameter active: True if radio is going to be active after event, false if radio was turned off (after tx/rx)
  */
 static void on_radio_evt(bool active)
 {
-  // If radio is turned off (was active) and enough time has passed since last measurement
-  if(false == active && millis() - last_battery_measurement > APPLICATION_BATTERY_INTERVAL)
+  TRACE_EVENT(TRACE_RADIO, active);
+  (void)ringbuffer_spsc_push(&radio_events, &active);
+}
+
+/**
+ * Handle radio notifications queued by on_radio_evt. Call from main loop.
+ * Notifications come in pairs at most once per advertisement, a full queue loses only stale pairs.
+ */
+static void radio_events_process(void)
+{
+  bool active;
+  while(ringbuffer_spsc_pop(&radio_events, &active))
   {
-    vbat = getBattery();
-    last_battery_measurement = millis();
+    // If radio is turned off (was active) and enough time has passed since last measurement
+    if(false == active && millis() - last_battery_measurement > APPLICATION_BATTERY_INTERVAL)
+    {
+      vbat = getBattery();
+      last_battery_measurement = millis();
+    }
   }
 }
 
@@ -473,6 +797,12 @@ int main(void)
   init_leds();
   RED_LED_ON;
 
+  // Cycle counter for execution time statistics, see profiler.h
+  profiler_init();
+  set_profiler_handler(profiler_handler);
+  set_trace_handler(trace_handler);
+  set_movement_detector_handler(capture_handler);
+
   if( init_log() ) { init_status |=LOG_FAILED_INIT; }
   else { NRF_LOG_INFO("LOG initialized \r\n"); } // subsequent initializations assume log is working
   
@@ -518,6 +848,7 @@ int main(void)
     init_status |= BUTTON_FAILED_INIT;
   }
 
+#if APPLICATION_DOOR_SWITCH_ENABLED
   //Checks state of the switch
   switch_check();
   
@@ -525,6 +856,7 @@ int main(void)
     {
       init_status |= SW_INT_FAILED_INIT;
     }
+#endif
 
   // Initialize BLE Stack. Starts LFCLK required for timer operation.
   if( init_ble() ) { init_status |= BLE_FAILED_INIT; }
@@ -532,9 +864,18 @@ int main(void)
   bluetooth_tx_power_set(BLE_TX_POWER);
   bluetooth_configure_advertising_interval(ADVERTISING_INTERVAL_STARTUP);
 
+  // DSP chain channels fed by accelerometer, transmission timers need app_timer from BLE init.
+  // FIFO batches go to chain in one call through the block handler.
+  if(lis2dh12_available)
+  {
+    chain_handler_init();
+    set_chain_handler(chain_handler);
+    set_chain_block_handler(chain_block_handler);
+  }
+
   // Priorities 2 and 3 are after SD timing critical events. 
   // 6, 7 after SD non-critical events.
-  // Triggers ADC, so use 3. 
+  // Handler only queues the event, ADC is triggered from main loop.
   ble_radio_notification_init(3,
                               NRF_RADIO_NOTIFICATION_DISTANCE_800US,
                               on_radio_evt);
@@ -574,30 +915,75 @@ int main(void)
     lis2dh12_reset(); // Clear memory.
     
     // Enable Low-To-Hi rising edge trigger interrupt on nRF52 to detect acceleration events.
-    if (pin_interrupt_enable(INT_ACC2_PIN, NRF_GPIOTE_POLARITY_LOTOHI, NRF_GPIO_PIN_NOPULL, lis2dh12_int2_handler) )
+    if (pin_interrupt_enable(ACC_ACTIVITY_PIN, NRF_GPIOTE_POLARITY_LOTOHI, NRF_GPIO_PIN_NOPULL, lis2dh12_activity_handler) )
+    {
+      init_status |= ACC_INT_FAILED_INIT;
+    }
+#if APPLICATION_KNOCK_ENABLED
+    if (pin_interrupt_enable(INT_ACC1_PIN, NRF_GPIOTE_POLARITY_LOTOHI, NRF_GPIO_PIN_NOPULL, lis2dh12_knock_handler) )
     {
       init_status |= ACC_INT_FAILED_INIT;
     }
+#endif
+#if APPLICATION_SLEEP_TO_WAKE_ENABLED
+    // Both edges, level tells if sensor went to sleep or woke up.
+    if (pin_interrupt_enable(INT_ACC2_PIN, NRF_GPIOTE_POLARITY_TOGGLE, NRF_GPIO_PIN_NOPULL, lis2dh12_sleep_handler) )
+    {
+      init_status |= ACC_INT_FAILED_INIT;
+    }
+#endif
     
     nrf_delay_ms(10); // Wait for LIS reboot.
     // Enable XYZ axes.
     lis2dh12_enable();
     lis2dh12_set_scale(LIS2DH12_SCALE);
-    lis2dh12_set_sample_rate(LIS2DH12_SAMPLERATE_RAWv1);
+    lis2dh12_set_sample_rate(ACC_IDLE_SAMPLERATE);
     lis2dh12_set_resolution(LIS2DH12_RESOLUTION);
 
     lis2dh12_set_activity_interrupt_pin_2(LIS2DH12_ACTIVITY_THRESHOLD);
+#if APPLICATION_CAPTURE_ENABLED
+    lis2dh12_capture_arm(LIS2DH12_SAMPLERATE_CAPTURE, ACC_ACTIVITY_INT);
+#endif
+#if APPLICATION_KNOCK_ENABLED
+    lis2dh12_set_tap_interrupt(LIS2DH12_KNOCK_CLICK_CFG, LIS2DH12_KNOCK_THRESHOLD, LIS2DH12_KNOCK_TIME_LIMIT,
+                               LIS2DH12_KNOCK_LATENCY, LIS2DH12_KNOCK_WINDOW, 1);
+#endif
+#if APPLICATION_SLEEP_TO_WAKE_ENABLED
+    // Activity interrupt function 2 to INT1 pin, INT2 pin only signals inactivity.
+    // Inactivity duration is counted in samples, lis2dh12_set_sample_rate keeps it in ms.
+    lis2dh12_set_interrupts(LIS2DH12_I1_IA2, 1);
+    lis2dh12_set_interrupts(LIS2DH12_NO_INTERRUPTS, 2);
+    lis2dh12_set_sleep_to_wake(LIS2DH12_INACTIVITY_THRESHOLD, LIS2DH12_INACTIVITY_DURATION);
+#endif
     NRF_LOG_INFO("Accelerometer configuration done \r\n");
   }
   if(bme280_available)
   {
     // oversampling must be set for each used sensor.
-    bme280_set_oversampling_hum  (BME280_HUMIDITY_OVERSAMPLING);
-    bme280_set_oversampling_temp (BME280_TEMPERATURE_OVERSAMPLING);
-    bme280_set_oversampling_press(BME280_PRESSURE_OVERSAMPLING);
-    bme280_set_iir(BME280_IIR);
-    bme280_set_interval(BME280_DELAY);
-    bme280_set_mode(BME280_MODE_NORMAL);
+    bme280_config_t bme280_config = {
+      .os_hum   = BME280_HUMIDITY_OVERSAMPLING,
+      .os_temp  = BME280_TEMPERATURE_OVERSAMPLING,
+      .os_press = BME280_PRESSURE_OVERSAMPLING,
+      .interval = BME280_DELAY
+    };
+#if APPLICATION_BME280_FORCED_ENABLED
+    // Configuration write starts first conversion before first advertisement
+    bme280_config.iir  = BME280_IIR_OFF;
+    bme280_config.mode = BME280_MODE_FORCED;
+    bme280_set_software_iir(BME280_SOFTWARE_IIR);
+    BME280_Ret bme280_status = bme280_configure(&bme280_config);
+    // Round up to full milliseconds
+    bme280_measurement_ms = (bme280_measurement_time_us() + 999) / 1000;
+    if(BME280_RET_OK == bme280_status)
+    {
+      nrf_delay_ms(bme280_measurement_ms);
+      bme280_measurement_ready = true;
+    }
+#else
+    bme280_config.iir  = BME280_IIR;
+    bme280_config.mode = BME280_MODE_NORMAL;
+    bme280_configure(&bme280_config);
+#endif
     NRF_LOG_INFO("BME280 configuration done \r\n");
   }
   
@@ -614,6 +1000,14 @@ int main(void)
   // Init starts timers, stop the reset
   app_timer_stop(reset_timer_id);
 
+#if APPLICATION_BME280_FORCED_ENABLED
+  // Started for each conversion by bme280_trigger_task
+  if( app_timer_create(&bme280_timer_id, APP_TIMER_MODE_SINGLE_SHOT, bme280_timer_handler) )
+  {
+    init_status |= TIMER_FAILED_INIT;
+  }
+#endif
+
   // Log errors, add a note to NFC, blink RED to visually indicate the problem
   if (init_status)
   { 
@@ -652,6 +1046,9 @@ int main(void)
   // Enter main loop. Executes tasks scheduled by timers and interrupts.
   for (;;)
   {
+    // Handle events queued by interrupts, then scheduled tasks.
+    pin_interrupt_process();
+    radio_events_process();
     app_sched_execute();
     // Sleep until next event.
     power_manage();